@@ -0,0 +1,263 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <memory>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[4] = { 'S', 'P', 'A', 'K' };
+
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+};
+
+AssetPack::AssetPack(const std::string& path) {
+    if (map(path) && !parse(path))
+        unmap();
+}
+
+AssetPack::~AssetPack() {
+    unmap();
+}
+
+#ifdef _WIN32
+bool AssetPack::map(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!view) {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = (const unsigned char*)view;
+    fileSize = (size_t)size.QuadPart;
+    return true;
+}
+
+void AssetPack::unmap() {
+    if (base)
+        UnmapViewOfFile(base);
+    if (mappingHandle)
+        CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle)
+        CloseHandle((HANDLE)fileHandle);
+    base = nullptr;
+    mappingHandle = fileHandle = nullptr;
+}
+#else
+bool AssetPack::map(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat status;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && status.st_size > 0)
+        view = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // The mapping keeps the file alive
+    if (view == MAP_FAILED)
+        return false;
+    base = (const unsigned char*)view;
+    fileSize = (size_t)status.st_size;
+    return true;
+}
+
+void AssetPack::unmap() {
+    if (base)
+        munmap((void*)base, fileSize);
+    base = nullptr;
+}
+#endif
+
+// Validate the header and that every entry lies inside the file, so lookups
+// never read past the mapping
+bool AssetPack::parse(const std::string& path) {
+    PackHeader header;
+    bool valid = fileSize >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, base, sizeof(header));
+        valid = !std::memcmp(header.magic, MAGIC, 4) && header.version == VERSION
+            && header.tocOffset % alignof(Entry) == 0 && header.tocOffset <= fileSize
+            && header.entryCount <= (fileSize - header.tocOffset) / sizeof(Entry)
+            && header.namesOffset <= fileSize;
+    }
+    if (valid) {
+        entries = (const Entry*)(base + header.tocOffset);
+        entryCount = header.entryCount;
+        names = (const char*)(base + header.namesOffset);
+        size_t namesSize = fileSize - header.namesOffset;
+        for (uint32_t i = 0; i < entryCount && valid; ++i) {
+            const Entry& entry = entries[i];
+            valid = entry.offset <= fileSize && entry.size <= fileSize - entry.offset
+                && entry.nameOffset <= namesSize && entry.nameLength <= namesSize - entry.nameOffset;
+        }
+    }
+    if (!valid)
+        std::cout << "ERROR::ASSET_PACK::INVALID_FILE: " << path << std::endl;
+    return valid;
+}
+
+std::string AssetPack::getName(int entry) const {
+    return std::string(names + entries[entry].nameOffset, entries[entry].nameLength);
+}
+
+AssetPack::Asset AssetPack::getAsset(int entry) const {
+    Asset asset;
+    asset.data = base + entries[entry].offset;
+    asset.size = (size_t)entries[entry].size;
+    asset.hash = entries[entry].hash;
+    return asset;
+}
+
+// Binary search over the sorted table of contents
+bool AssetPack::Find(const std::string& name, Asset& asset) const {
+    if (!base)
+        return false;
+    const Entry* end = entries + entryCount;
+    const Entry* found = std::lower_bound(entries, end, name, [this](const Entry& entry, const std::string& key) {
+        return key.compare(0, std::string::npos, names + entry.nameOffset, entry.nameLength) > 0;
+    });
+    if (found == end || name.compare(0, std::string::npos, names + found->nameOffset, found->nameLength) != 0)
+        return false;
+    asset = getAsset((int)(found - entries));
+    return true;
+}
+
+bool AssetPack::Verify() const {
+    bool valid = isValid();
+    for (int i = 0; i < getEntryCount() && valid; ++i) {
+        Asset asset = getAsset(i);
+        if (Hash(asset.data, asset.size) != asset.hash) {
+            std::cout << "ERROR::ASSET_PACK::HASH_MISMATCH: " << getName(i) << std::endl;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+bool AssetPack::Write(const std::string& path, const std::vector<std::string>& files) {
+    std::vector<std::string> sorted(files);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary);
+    if (!out) {
+        std::cout << "ERROR::ASSET_PACK::WRITE_FAILED: " << tempPath << std::endl;
+        return false;
+    }
+
+    PackHeader header = {};
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.entryCount = (uint32_t)sorted.size();
+    out.write((const char*)&header, sizeof(header));
+
+    static const char padding[ALIGNMENT] = {};
+    std::vector<Entry> toc;
+    std::string nameTable;
+    uint64_t offset = sizeof(header);
+    for (const std::string& name : sorted) {
+        std::ifstream file(name, std::ios::binary);
+        if (!file) {
+            std::cout << "ERROR::ASSET_PACK::FILE_NOT_SUCCESFULLY_READ: " << name << std::endl;
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        uint64_t aligned = (offset + ALIGNMENT - 1) & ~(uint64_t)(ALIGNMENT - 1);
+        out.write(padding, (std::streamsize)(aligned - offset));
+        out.write((const char*)data.data(), (std::streamsize)data.size());
+        offset = aligned + data.size();
+
+        Entry entry;
+        entry.offset = aligned;
+        entry.size = data.size();
+        entry.hash = Hash(data.data(), data.size());
+        entry.nameOffset = (uint32_t)nameTable.size();
+        entry.nameLength = (uint32_t)name.size();
+        toc.push_back(entry);
+        nameTable += name;
+    }
+
+    header.tocOffset = (offset + alignof(Entry) - 1) & ~(uint64_t)(alignof(Entry) - 1);
+    header.namesOffset = header.tocOffset + toc.size() * sizeof(Entry);
+    out.write(padding, (std::streamsize)(header.tocOffset - offset));
+    out.write((const char*)toc.data(), (std::streamsize)(toc.size() * sizeof(Entry)));
+    out.write(nameTable.data(), (std::streamsize)nameTable.size());
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    out.close();
+    if (!out) {
+        std::cout << "ERROR::ASSET_PACK::WRITE_FAILED: " << tempPath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // Readers see either the old pack or the complete new one
+#ifdef _WIN32
+    bool renamed = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool renamed = std::rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed) {
+        std::cout << "ERROR::ASSET_PACK::RENAME_FAILED: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint64_t AssetPack::Hash(const unsigned char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static std::unique_ptr<AssetPack>& mountedPack() {
+    static std::unique_ptr<AssetPack> pack;
+    return pack;
+}
+
+bool AssetPack::Mount(const std::string& path) {
+    std::unique_ptr<AssetPack> pack(new AssetPack(path));
+    if (!pack->isValid())
+        return false;
+    mountedPack() = std::move(pack);
+    return true;
+}
+
+const AssetPack* AssetPack::Mounted() {
+    return mountedPack().get();
+}
@@ -0,0 +1,87 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only archive of assets (shaders, cooked textures, images) mapped into
+// memory with mmap / MapViewOfFile. Lookups return pointers into the mapping,
+// so shader sources and cooked mip levels go to GL without being read into
+// intermediate buffers, and pages are only faulted in when used.
+//
+// Replacing one .pak file (written to a temporary name and renamed over the
+// old one) swaps every asset at once.
+//
+// .pak layout (little endian):
+//   char magic[4] = "SPAK", uint32 version, uint32 entryCount, uint32 reserved,
+//   uint64 tocOffset, uint64 namesOffset
+//   payloads, each aligned to ALIGNMENT bytes
+//   entryCount x { uint64 offset, uint64 size, uint64 hash, uint32 nameOffset, uint32 nameLength },
+//   sorted by name; names are relative paths such as "planet.vs" or "assets/earth.stex"
+class AssetPack {
+public:
+    static const uint32_t VERSION = 1;
+    static const size_t ALIGNMENT = 4096;   // Payloads start on their own page
+
+    struct Asset {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        uint64_t hash = 0;   // Content hash recorded when packing
+    };
+
+    // Maps the file; check isValid()
+    explicit AssetPack(const std::string& path);
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool isValid() const { return base != nullptr; }
+
+    // Looks name up in the table of contents; false if it is not packed
+    bool Find(const std::string& name, Asset& asset) const;
+
+    int getEntryCount() const { return (int)entryCount; }
+    std::string getName(int entry) const;
+    Asset getAsset(int entry) const;
+
+    // Rehashes every payload against the table of contents (touches the whole file)
+    bool Verify() const;
+
+    // Packs files under their given names; writes path.tmp and renames it over path
+    static bool Write(const std::string& path, const std::vector<std::string>& files);
+
+    // 64-bit FNV-1a
+    static uint64_t Hash(const unsigned char* data, size_t size);
+
+    // Process-wide pack consulted by Shader, RgbImage and CookedTexture before
+    // loose files. Mount before creating the Scene; the pack stays mapped until
+    // exit. Returns false (loose files are used) if path is missing or invalid.
+    static bool Mount(const std::string& path);
+    static const AssetPack* Mounted();
+
+private:
+    struct Entry {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t hash;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    const unsigned char* base = nullptr;
+    size_t fileSize = 0;
+    const Entry* entries = nullptr;
+    uint32_t entryCount = 0;
+    const char* names = nullptr;
+    void* fileHandle = nullptr;      // Windows only
+    void* mappingHandle = nullptr;   // Windows only
+
+    bool map(const std::string& path);
+    void unmap();
+    bool parse(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "AsteroidCatalog.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include <glm/glm.hpp>
+
+// Scene orbit radius for a distance in AU, linear between the planets' orbits
+static float sceneDistance(float au) {
+    static const float planetAU[] = { 0.0f, 0.387f, 0.723f, 1.0f, 1.524f, 5.203f, 9.537f, 19.19f };
+    static const float planetScene[] = { 0.0f, 40.0f, 60.0f, 85.0f, 110.0f, 150.0f, 230.0f, 300.0f };
+    const int count = sizeof(planetAU) / sizeof(planetAU[0]);
+
+    for (int i = 1; i < count; ++i) {
+        if (au <= planetAU[i] || i == count - 1) {
+            float t = (au - planetAU[i - 1]) / (planetAU[i] - planetAU[i - 1]);
+            return planetScene[i - 1] + t * (planetScene[i] - planetScene[i - 1]);
+        }
+    }
+    return au;
+}
+
+OrbitalElements AsteroidCatalog::ToScene(float semiMajorAxisAU, float eccentricity, float inclination,
+    float ascendingNode, float periapsis, float meanAnomaly)
+{
+    OrbitalElements orbit;
+    orbit.semiMajorAxis = sceneDistance(semiMajorAxisAU);
+    orbit.eccentricity = eccentricity;
+    orbit.inclination = glm::radians(inclination);
+    orbit.ascendingNode = glm::radians(ascendingNode);
+    orbit.periapsis = glm::radians(periapsis);
+    orbit.meanAnomaly = glm::radians(meanAnomaly);
+    orbit.meanMotion = 1.0f / (semiMajorAxisAU * std::sqrt(semiMajorAxisAU));
+    return orbit;
+}
+
+void AsteroidCatalog::GenerateMainBelt(int count, unsigned seed) {
+    orbits.Clear();
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+
+    // Resonances with Jupiter (3:1, 5:2, 7:3, 2:1) where few asteroids survive
+    static const float gaps[] = { 2.502f, 2.825f, 2.958f, 3.279f };
+
+    while (orbits.getCount() < count) {
+        float a = 2.1f + 1.2f * unit(rng);
+        bool inGap = false;
+        for (float gap : gaps)
+            inGap |= std::fabs(a - gap) < 0.015f;
+        if (inGap)
+            continue;
+
+        float e = std::fabs(normal(rng)) * 0.1f;
+        float i = std::fabs(normal(rng)) * 7.0f;
+        if (e >= 0.6f)
+            continue;
+        orbits.Add(ToScene(a, e, i, 360.0f * unit(rng), 360.0f * unit(rng), 360.0f * unit(rng)));
+    }
+}
+
+bool AsteroidCatalog::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "ERROR::ASTEROIDS::FILE_NOT_READ " << path << std::endl;
+        return false;
+    }
+
+    orbits.Clear();
+    std::string line;
+    int lineNumber = 0, rejected = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        std::istringstream row(line);
+        float a, e, i, node, periapsis, M;
+        if (!(row >> a >> e >> i >> node >> periapsis >> M)) {
+            std::cout << "ERROR::ASTEROIDS::MALFORMED_ROW " << path << ":" << lineNumber << std::endl;
+            continue;
+        }
+        // Orbits the solver is not verified for (see MAX_ECCENTRICITY)
+        if (!(a > 0.0f && e >= 0.0f && e <= MAX_ECCENTRICITY)) {
+            ++rejected;
+            continue;
+        }
+        orbits.Add(ToScene(a, e, i, node, periapsis, M));
+    }
+    if (rejected > 0)
+        std::cout << "ERROR::ASTEROIDS::ORBITS_OUT_OF_RANGE " << rejected << " rows with a <= 0 or e outside [0, "
+                  << MAX_ECCENTRICITY << "] in " << path << std::endl;
+    return orbits.getCount() > 0;
+}
@@ -0,0 +1,41 @@
+#ifndef ASTEROID_CATALOG_H
+#define ASTEROID_CATALOG_H
+
+#include <string>
+#include "Kepler.h"
+
+// Orbits of minor bodies kept only as float32 element arrays (KeplerBatch),
+// about 44 bytes per object, so the full main belt (~1M objects) fits in a
+// few tens of megabytes and is propagated in closed form every frame.
+class AsteroidCatalog {
+public:
+    // Synthetic main belt: semi-major axes 2.1-3.3 AU with the Kirkwood gaps
+    // cleared, Rayleigh-like eccentricities and inclinations
+    void GenerateMainBelt(int count, unsigned seed = 1);
+
+    // Loads whitespace separated rows "a e i node periapsis M" (AU, degrees),
+    // e.g. trimmed from an MPCORB or JPL SBDB export. Malformed rows are
+    // reported by line and skipped, as are orbits with e > MAX_ECCENTRICITY;
+    // false if unreadable or nothing was loaded
+    bool Load(const std::string& path);
+
+    // Elements in real units (AU, degrees, mean anomaly at t = 0) mapped into
+    // the scene: distances follow the planets' compressed radii and mean motion
+    // is Kepler's third law with Earth at 1 rad/s
+    static OrbitalElements ToScene(float semiMajorAxisAU, float eccentricity, float inclination,
+        float ascendingNode, float periapsis, float meanAnomaly);
+
+    int getCount() const { return orbits.getCount(); }
+
+    // Positions at time t, interleaved: xyz[i * stride + 0..2] (parallel, SIMD)
+    void Propagate(double t, float* xyz, int stride = 3) const {
+        orbits.Propagate(t, xyz, xyz + 1, xyz + 2, stride);
+    }
+
+    const KeplerBatch& getOrbits() const { return orbits; }
+
+private:
+    KeplerBatch orbits;
+};
+
+#endif
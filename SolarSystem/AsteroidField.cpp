@@ -0,0 +1,63 @@
+#include "AsteroidField.h"
+#include <iostream>
+#include <utility>
+
+AsteroidField::AsteroidField(AsteroidCatalog&& catalog) : catalog(std::move(catalog)) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)this->catalog.getCount() * 3 * sizeof(float), NULL, GL_STREAM_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+}
+
+AsteroidField::~AsteroidField() {
+    delete feedback;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+}
+
+void AsteroidField::SetGpuPropagation(bool enabled) {
+    gpuPropagation = enabled;
+    if (enabled && !feedback)
+        feedback = new KeplerFeedback(catalog.getOrbits());
+}
+
+void AsteroidField::Update(double t) {
+    valid = false;
+    if (catalog.getCount() == 0)
+        return;
+
+    if (gpuPropagation) {
+        feedback->Propagate(t, VBO);
+        valid = true;
+        return;
+    }
+
+    // Invalidating the whole buffer lets the driver hand out fresh storage
+    // instead of waiting for last frame's draw to finish reading it
+    GLsizeiptr size = (GLsizeiptr)catalog.getCount() * 3 * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    float* positions = (float*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!positions) {
+        std::cout << "ERROR::ASTEROIDS::MAP_FAILED" << std::endl;
+        return;
+    }
+
+    catalog.Propagate(t, positions);
+    valid = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+}
+
+void AsteroidField::Draw() const {
+    if (!valid)
+        return;
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_POINTS, 0, catalog.getCount());
+    glBindVertexArray(0);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+}
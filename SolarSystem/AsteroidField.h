@@ -0,0 +1,43 @@
+#ifndef ASTEROID_FIELD_H
+#define ASTEROID_FIELD_H
+
+#include <glad/glad.h>
+#include "AsteroidCatalog.h"
+#include "KeplerFeedback.h"
+
+// Draws an asteroid catalog as point sprites. Every frame the vertex buffer is
+// mapped (orphaned) and the job system propagates all orbits straight into it,
+// so positions never pass through an intermediate copy. Only mapping, unmapping
+// and drawing happen on the GL thread. With GPU propagation enabled the same
+// buffer is filled by transform feedback instead (KeplerFeedback) and the CPU
+// does no per-asteroid work at all.
+class AsteroidField {
+public:
+    explicit AsteroidField(AsteroidCatalog&& catalog);
+    ~AsteroidField();
+
+    AsteroidField(const AsteroidField&) = delete;
+    AsteroidField& operator=(const AsteroidField&) = delete;
+
+    // Propagates every asteroid to simulation time t into the vertex buffer
+    void Update(double t);
+
+    // Switches between the SIMD CPU path and transform feedback; the GPU
+    // copy of the elements is uploaded on first use
+    void SetGpuPropagation(bool enabled);
+    bool getGpuPropagation() const { return gpuPropagation; }
+
+    // Draws the points with GL_PROGRAM_POINT_SIZE; the asteroid shader must be bound
+    void Draw() const;
+
+    int getCount() const { return catalog.getCount(); }
+
+private:
+    AsteroidCatalog catalog;
+    KeplerFeedback* feedback = nullptr;
+    GLuint VAO = 0, VBO = 0;
+    bool gpuPropagation = false;
+    bool valid = false;   // Buffer holds positions from the last Update
+};
+
+#endif
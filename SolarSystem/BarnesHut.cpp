@@ -0,0 +1,169 @@
+#include "BarnesHut.h"
+#include <algorithm>
+#include <cmath>
+
+#include "JobSystem.h"
+
+// Spreads the low 21 bits of v so there are two zero bits between each
+static uint64_t expandBits(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+void BarnesHutTree::Build(const float* px, const float* py, const float* pz, const float* mass, int count) {
+    nodes.clear();
+    order.resize(count);
+    keys.resize(count);
+    sx.resize(count); sy.resize(count); sz.resize(count); sm.resize(count);
+    if (count == 0)
+        return;
+
+    // Bounding cube of all bodies
+    float minX = px[0], minY = py[0], minZ = pz[0];
+    float maxX = minX, maxY = minY, maxZ = minZ;
+    for (int i = 1; i < count; ++i) {
+        minX = std::min(minX, px[i]); maxX = std::max(maxX, px[i]);
+        minY = std::min(minY, py[i]); maxY = std::max(maxY, py[i]);
+        minZ = std::min(minZ, pz[i]); maxZ = std::max(maxZ, pz[i]);
+    }
+    float size = std::max(std::max(maxX - minX, maxY - minY), std::max(maxZ - minZ, 1e-6f));
+
+    // Quantize to the Morton grid and sort along the curve
+    const float cells = (float)((1 << MORTON_BITS) - 1);
+    const float scale = cells / size;
+    auto quantize = [cells](float v) { return (uint64_t)std::min(std::max(v, 0.0f), cells); };
+    for (int i = 0; i < count; ++i) {
+        uint64_t x = quantize((px[i] - minX) * scale);
+        uint64_t y = quantize((py[i] - minY) * scale);
+        uint64_t z = quantize((pz[i] - minZ) * scale);
+        keys[i] = { expandBits(x) << 2 | expandBits(y) << 1 | expandBits(z), i };
+    }
+    std::sort(keys.begin(), keys.end());
+
+    for (int i = 0; i < count; ++i) {
+        int body = keys[i].second;
+        order[i] = body;
+        sx[i] = px[body]; sy[i] = py[body]; sz[i] = pz[body]; sm[i] = mass[body];
+    }
+
+    nodes.resize(1);
+    buildNode(0, 0, count, 0, size);
+}
+
+void BarnesHutTree::buildNode(int index, int begin, int end, int level, float size) {
+    int firstChild = -1, childCount = 0;
+
+    if (end - begin > leafSize && level < MORTON_BITS) {
+        // Children are the runs of equal digits at this level
+        const int shift = 3 * (MORTON_BITS - 1 - level);
+        int bounds[9];
+        int digitCount = 0;
+        for (int i = begin; i < end; ) {
+            uint64_t digit = keys[i].first >> shift & 7;
+            bounds[digitCount++] = i;
+            while (i < end && (keys[i].first >> shift & 7) == digit)
+                ++i;
+        }
+        bounds[digitCount] = end;
+
+        // Reserve siblings together; the pool may reallocate, so work by index
+        firstChild = (int)nodes.size();
+        childCount = digitCount;
+        nodes.resize(nodes.size() + childCount);
+        for (int c = 0; c < childCount; ++c)
+            buildNode(firstChild + c, bounds[c], bounds[c + 1], level + 1, size * 0.5f);
+    }
+
+    double mass = 0.0, x = 0.0, y = 0.0, z = 0.0;
+    if (firstChild < 0) {
+        for (int i = begin; i < end; ++i) {
+            mass += sm[i];
+            x += (double)sm[i] * sx[i]; y += (double)sm[i] * sy[i]; z += (double)sm[i] * sz[i];
+        }
+    }
+    else {
+        for (int c = firstChild; c < firstChild + childCount; ++c) {
+            const Node& child = nodes[c];
+            mass += child.mass;
+            x += (double)child.mass * child.comX; y += (double)child.mass * child.comY; z += (double)child.mass * child.comZ;
+        }
+    }
+
+    Node& node = nodes[index];
+    if (mass > 0.0) {
+        node.comX = (float)(x / mass); node.comY = (float)(y / mass); node.comZ = (float)(z / mass);
+    }
+    else {
+        // Massless cell: any point inside works, it never contributes
+        node.comX = sx[begin]; node.comY = sy[begin]; node.comZ = sz[begin];
+    }
+    node.mass = (float)mass;
+    node.size = size;
+    node.firstChild = firstChild;
+    node.childCount = childCount;
+    node.bodyBegin = begin;
+    node.bodyEnd = end;
+}
+
+void BarnesHutTree::accelerationAt(float x, float y, float z, float eps2, float& ax, float& ay, float& az) const {
+    const float theta2 = theta * theta;
+    float sumX = 0.0f, sumY = 0.0f, sumZ = 0.0f;
+
+    // Depth is at most MORTON_BITS levels with up to 7 pending siblings each
+    int stack[8 * (MORTON_BITS + 1)];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        float dx = node.comX - x, dy = node.comY - y, dz = node.comZ - z;
+        float d2 = dx * dx + dy * dy + dz * dz;
+
+        if (node.firstChild >= 0 && node.size * node.size >= theta2 * d2) {
+            for (int c = node.firstChild; c < node.firstChild + node.childCount; ++c)
+                stack[top++] = c;
+            continue;
+        }
+
+        if (node.firstChild < 0 && node.size * node.size >= theta2 * d2) {
+            // Near leaf: sum its bodies directly (the body itself adds zero)
+            for (int i = node.bodyBegin; i < node.bodyEnd; ++i) {
+                float bx = sx[i] - x, by = sy[i] - y, bz = sz[i] - z;
+                float inv = 1.0f / std::sqrt(bx * bx + by * by + bz * bz + eps2);
+                float s = sm[i] * inv * inv * inv;
+                sumX += bx * s; sumY += by * s; sumZ += bz * s;
+            }
+            continue;
+        }
+
+        // Far cell: point mass at its center of mass
+        float inv = 1.0f / std::sqrt(d2 + eps2);
+        float s = node.mass * inv * inv * inv;
+        sumX += dx * s; sumY += dy * s; sumZ += dz * s;
+    }
+
+    ax = sumX; ay = sumY; az = sumZ;
+}
+
+void BarnesHutTree::ComputeAccelerations(float G, float softening, float* ax, float* ay, float* az) const {
+    if (nodes.empty())
+        return;
+
+    // Walk bodies in Morton order so consecutive traversals in a job touch the same cells
+    const float eps2 = softening * softening;
+    JobSystem::Get().ParallelFor(0, (int)order.size(), 256, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            float x, y, z;
+            accelerationAt(sx[i], sy[i], sz[i], eps2, x, y, z);
+            int body = order[i];
+            ax[body] = G * x;
+            ay[body] = G * y;
+            az[body] = G * z;
+        }
+    });
+}
@@ -0,0 +1,51 @@
+#ifndef BARNES_HUT_H
+#define BARNES_HUT_H
+
+#include <cstdint>
+#include <vector>
+
+// Octree for O(N log N) gravity. Bodies are sorted by Morton code, so every
+// cell covers a contiguous range of the sorted order and the tree is built
+// top-down by splitting ranges on successive 3-bit Morton digits. Nodes live
+// in one pool that keeps its capacity between builds; a node's children are
+// stored next to each other. Cells that look smaller than theta (size over
+// distance to their center of mass) are approximated by a point mass.
+class BarnesHutTree {
+public:
+    float theta = 0.5f;   // Opening angle; 0 degenerates to the direct sum
+    int leafSize = 8;     // Bodies per leaf before a cell is split
+
+    // Rebuilds the tree for count bodies (arrays indexed by body)
+    void Build(const float* px, const float* py, const float* pz, const float* mass, int count);
+
+    // Writes G-scaled accelerations for every body of the last build (on the job system)
+    void ComputeAccelerations(float G, float softening, float* ax, float* ay, float* az) const;
+
+    int getNodeCount() const { return (int)nodes.size(); }
+    int getBodyCount() const { return (int)order.size(); }
+
+private:
+    static const int MORTON_BITS = 21;   // Bits per axis, 63-bit codes
+
+    struct Node {
+        float comX, comY, comZ;   // Center of mass
+        float mass;
+        float size;               // Edge length of the cell
+        int firstChild;           // Pool index of the first child, -1 for leaves
+        int childCount;
+        int bodyBegin, bodyEnd;   // Range in Morton order
+    };
+
+    std::vector<Node> nodes;                          // Pool, root at index 0
+    std::vector<std::pair<uint64_t, int>> keys;       // Morton code and body index
+    std::vector<int> order;                           // Morton position -> body index
+    std::vector<float> sx, sy, sz, sm;                // Bodies in Morton order
+
+    // Fills nodes[index] for bodies [begin, end) sharing their first level digits
+    void buildNode(int index, int begin, int end, int level, float size);
+
+    // Acceleration (without G) at a point from the whole tree
+    void accelerationAt(float x, float y, float z, float eps2, float& ax, float& ay, float& az) const;
+};
+
+#endif
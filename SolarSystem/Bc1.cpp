@@ -0,0 +1,218 @@
+#include "Bc1.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "JobSystem.h"
+
+namespace bc1 {
+
+size_t CompressedSize(int width, int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
+static int pack565(const float color[3]) {
+    int r = (int)std::lround(std::min(std::max(color[0], 0.0f), 255.0f) * 31.0f / 255.0f);
+    int g = (int)std::lround(std::min(std::max(color[1], 0.0f), 255.0f) * 63.0f / 255.0f);
+    int b = (int)std::lround(std::min(std::max(color[2], 0.0f), 255.0f) * 31.0f / 255.0f);
+    return (r << 11) | (g << 5) | b;
+}
+
+static void unpack565(int packed, int color[3]) {
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// Four-color palette of a block with c0 > c1
+static void palette(int c0, int c1, int colors[4][3]) {
+    unpack565(c0, colors[0]);
+    unpack565(c1, colors[1]);
+    for (int c = 0; c < 3; ++c) {
+        colors[2][c] = (2 * colors[0][c] + colors[1][c]) / 3;
+        colors[3][c] = (colors[0][c] + 2 * colors[1][c]) / 3;
+    }
+}
+
+// Nearest palette entry per texel; returns the total squared error
+static int assignIndices(const unsigned char texels[16][3], int c0, int c1, int indices[16]) {
+    int colors[4][3];
+    palette(c0, c1, colors);
+    int total = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0, bestError = 1 << 30;
+        for (int p = 0; p < 4; ++p) {
+            int dr = texels[i][0] - colors[p][0], dg = texels[i][1] - colors[p][1], db = texels[i][2] - colors[p][2];
+            int error = dr * dr + dg * dg + db * db;
+            if (error < bestError) {
+                bestError = error;
+                best = p;
+            }
+        }
+        indices[i] = best;
+        total += bestError;
+    }
+    return total;
+}
+
+// Orders the endpoints for four-color mode; false when they are equal
+static bool orderEndpoints(int& c0, int& c1) {
+    if (c0 < c1)
+        std::swap(c0, c1);
+    return c0 != c1;
+}
+
+static void writeBlock(int c0, int c1, const int indices[16], unsigned char block[8]) {
+    unsigned int bits = 0;
+    for (int i = 15; i >= 0; --i)
+        bits = (bits << 2) | (unsigned int)indices[i];
+    block[0] = (unsigned char)(c0 & 0xFF);
+    block[1] = (unsigned char)(c0 >> 8);
+    block[2] = (unsigned char)(c1 & 0xFF);
+    block[3] = (unsigned char)(c1 >> 8);
+    std::memcpy(block + 4, &bits, 4);
+}
+
+// Endpoints from the texels' principal axis (inset slightly to spend the
+// palette on the bulk of the colors), then one least-squares refit of the
+// endpoints to the chosen indices if that lowers the error
+static void encodeBlock(const unsigned char texels[16][3], unsigned char block[8]) {
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c)
+            mean[c] += texels[i][c] / 16.0f;
+
+    float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };   // rr rg rb gg gb bb
+    for (int i = 0; i < 16; ++i) {
+        float d[3] = { texels[i][0] - mean[0], texels[i][1] - mean[1], texels[i][2] - mean[2] };
+        covariance[0] += d[0] * d[0]; covariance[1] += d[0] * d[1]; covariance[2] += d[0] * d[2];
+        covariance[3] += d[1] * d[1]; covariance[4] += d[1] * d[2]; covariance[5] += d[2] * d[2];
+    }
+
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[3] = {
+            covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+            covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+            covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2] };
+        float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (length < 1e-6f)
+            break;
+        for (int c = 0; c < 3; ++c)
+            axis[c] = next[c] / length;
+    }
+
+    float minT = 1e30f, maxT = -1e30f;
+    for (int i = 0; i < 16; ++i) {
+        float t = (texels[i][0] - mean[0]) * axis[0] + (texels[i][1] - mean[1]) * axis[1]
+                + (texels[i][2] - mean[2]) * axis[2];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    float inset = (maxT - minT) / 16.0f;
+    float high[3], low[3];
+    for (int c = 0; c < 3; ++c) {
+        high[c] = mean[c] + axis[c] * (maxT - inset);
+        low[c] = mean[c] + axis[c] * (minT + inset);
+    }
+
+    int c0 = pack565(high), c1 = pack565(low);
+    int indices[16] = {};
+    if (!orderEndpoints(c0, c1)) {
+        writeBlock(c0, c1, indices, block);
+        return;
+    }
+    int error = assignIndices(texels, c0, c1, indices);
+
+    // Least squares: texel = a * endpoint0 + b * endpoint1 with the index weights
+    static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[3] = {}, bx[3] = {};
+    for (int i = 0; i < 16; ++i) {
+        float a = weights[indices[i]], b = 1.0f - a;
+        aa += a * a; ab += a * b; bb += b * b;
+        for (int c = 0; c < 3; ++c) {
+            ax[c] += a * texels[i][c];
+            bx[c] += b * texels[i][c];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) > 1e-6f) {
+        float refitHigh[3], refitLow[3];
+        for (int c = 0; c < 3; ++c) {
+            refitHigh[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+            refitLow[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+        }
+        int r0 = pack565(refitHigh), r1 = pack565(refitLow);
+        int refitIndices[16];
+        if (orderEndpoints(r0, r1)) {
+            int refitError = assignIndices(texels, r0, r1, refitIndices);
+            if (refitError < error) {
+                c0 = r0;
+                c1 = r1;
+                std::memcpy(indices, refitIndices, sizeof(indices));
+            }
+        }
+    }
+    writeBlock(c0, c1, indices, block);
+}
+
+void Encode(const unsigned char* rgb, int width, int height, unsigned char* blocks) {
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    JobSystem::Get().ParallelFor(0, blocksY, 4, [&](int rowBegin, int rowEnd) {
+        unsigned char texels[16][3];
+        for (int by = rowBegin; by < rowEnd; ++by) {
+            for (int bx = 0; bx < blocksX; ++bx) {
+                // Edge blocks repeat the last row and column
+                for (int i = 0; i < 16; ++i) {
+                    int x = std::min(bx * 4 + (i & 3), width - 1);
+                    int y = std::min(by * 4 + (i >> 2), height - 1);
+                    std::memcpy(texels[i], rgb + ((size_t)y * width + x) * 3, 3);
+                }
+                encodeBlock(texels, blocks + ((size_t)by * blocksX + bx) * 8);
+            }
+        }
+    });
+}
+
+void Decode(const unsigned char* blocks, int width, int height, unsigned char* rgb) {
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            const unsigned char* block = blocks + ((size_t)by * blocksX + bx) * 8;
+            int c0 = block[0] | (block[1] << 8), c1 = block[2] | (block[3] << 8);
+            unsigned int bits;
+            std::memcpy(&bits, block + 4, 4);
+
+            int colors[4][3];
+            palette(c0, c1, colors);
+            if (c0 <= c1) {
+                // Three-color mode: midpoint and black
+                for (int c = 0; c < 3; ++c) {
+                    colors[2][c] = (colors[0][c] + colors[1][c]) / 2;
+                    colors[3][c] = 0;
+                }
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                int x = bx * 4 + (i & 3), y = by * 4 + (i >> 2);
+                if (x >= width || y >= height)
+                    continue;
+                const int* color = colors[(bits >> (2 * i)) & 3];
+                unsigned char* out = rgb + ((size_t)y * width + x) * 3;
+                out[0] = (unsigned char)color[0];
+                out[1] = (unsigned char)color[1];
+                out[2] = (unsigned char)color[2];
+            }
+        }
+    }
+}
+
+void SolidBlock(unsigned char r, unsigned char g, unsigned char b, unsigned char block[8]) {
+    float color[3] = { (float)r, (float)g, (float)b };
+    int packed = pack565(color);
+    int indices[16] = {};
+    writeBlock(packed, packed, indices, block);
+}
+
+}
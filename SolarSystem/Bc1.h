@@ -0,0 +1,25 @@
+#ifndef BC1_H
+#define BC1_H
+
+#include <cstddef>
+
+// BC1 (DXT1) block compression: every 4x4 texel block becomes 8 bytes, two
+// RGB565 endpoints and a 2-bit palette index per texel (6:1 against RGB8).
+// Images whose size is not a multiple of 4 use partial blocks at the edges.
+namespace bc1 {
+
+// Bytes of a width x height image
+size_t CompressedSize(int width, int height);
+
+// Compresses an RGB8 image into CompressedSize bytes (parallel over block rows)
+void Encode(const unsigned char* rgb, int width, int height, unsigned char* blocks);
+
+// Expands blocks back to RGB8 (tools and quality checks)
+void Decode(const unsigned char* blocks, int width, int height, unsigned char* rgb);
+
+// A block of one solid color
+void SolidBlock(unsigned char r, unsigned char g, unsigned char b, unsigned char block[8]);
+
+}
+
+#endif
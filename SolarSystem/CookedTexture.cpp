@@ -0,0 +1,220 @@
+#include "CookedTexture.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "AssetPack.h"
+#include "Bc1.h"
+
+static const char MAGIC[4] = { 'S', 'T', 'E', 'X' };
+static const size_t LEVEL_ALIGNMENT = 16;
+static const uint32_t MAX_SIZE = 1u << 16;   // Keeps every level size well inside int
+
+struct CookedHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+};
+
+struct CookedLevel {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Levels of a full mip chain down to 1x1, as RgbImage::BuildMips makes
+static uint32_t fullLevelCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size >>= 1)
+        ++levels;
+    return levels;
+}
+
+static bool parseHeader(const unsigned char* file, size_t size, CookedHeader& header) {
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, file, sizeof(header));
+    return !std::memcmp(header.magic, MAGIC, 4) && header.version == CookedTexture::VERSION
+        && header.format == CookedTexture::FORMAT_BC1 && header.width > 0 && header.height > 0
+        && header.width <= MAX_SIZE && header.height <= MAX_SIZE
+        && header.levelCount == fullLevelCount(header.width, header.height);
+}
+
+void CookedTexture::Encode(const RgbImage& image) {
+    width = image.width;
+    height = image.height;
+    mapped = nullptr;
+    firstLevel = 0;
+    lastLevel = image.getLevelCount() - 1;
+    levelOffsets.clear();
+    levelSizes.clear();
+    size_t total = 0;
+    for (int level = 0; level < image.getLevelCount(); ++level) {
+        levelOffsets.push_back(total);
+        levelSizes.push_back(bc1::CompressedSize(getLevelWidth(level), getLevelHeight(level)));
+        total += levelSizes.back();
+    }
+    data.resize(total);
+    for (int level = 0; level < image.getLevelCount(); ++level)
+        bc1::Encode(image.getLevel(level), getLevelWidth(level), getLevelHeight(level), &data[levelOffsets[level]]);
+}
+
+bool CookedTexture::Load(const std::string& path, int first, int last) {
+    // Header and level table, then the byte range of the requested levels
+    std::ifstream stream;
+    const unsigned char* file = nullptr;
+    size_t fileSize;
+    AssetPack::Asset asset;
+    const AssetPack* pack = AssetPack::Mounted();
+    std::vector<unsigned char> table;
+    if (pack && pack->Find(path, asset)) {
+        file = asset.data;
+        fileSize = asset.size;
+    }
+    else {
+        stream.open(path, std::ios::binary | std::ios::ate);
+        if (!stream) {
+            std::cout << "ERROR::COOKED_TEXTURE::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+            return false;
+        }
+        fileSize = (size_t)stream.tellg();
+        table.resize(std::min(fileSize, sizeof(CookedHeader) + 32 * sizeof(CookedLevel)));
+        stream.seekg(0);
+        stream.read((char*)table.data(), (std::streamsize)table.size());
+    }
+    const unsigned char* headerBytes = file ? file : table.data();
+    size_t headerBytesSize = file ? fileSize : table.size();
+
+    // Check the header and that the levels follow the table in order, without
+    // overlapping, and lie inside the file
+    CookedHeader header;
+    bool valid = parseHeader(headerBytes, headerBytesSize, header)
+        && sizeof(header) + header.levelCount * sizeof(CookedLevel) <= headerBytesSize;
+    std::vector<CookedLevel> levels;
+    if (valid) {
+        width = (int)header.width;
+        height = (int)header.height;
+        levels.resize(header.levelCount);
+        std::memcpy(levels.data(), headerBytes + sizeof(header), levels.size() * sizeof(CookedLevel));
+        uint64_t previousEnd = sizeof(header) + levels.size() * sizeof(CookedLevel);
+        for (uint32_t level = 0; level < header.levelCount && valid; ++level) {
+            valid = levels[level].size == bc1::CompressedSize(getLevelWidth(level), getLevelHeight(level))
+                && levels[level].offset >= previousEnd
+                && levels[level].offset <= fileSize && levels[level].size <= fileSize - levels[level].offset;
+            previousEnd = levels[level].offset + levels[level].size;
+        }
+        if (last < 0)
+            last = (int)header.levelCount - 1;
+        valid = valid && first >= 0 && first <= last && last < (int)header.levelCount;
+    }
+    if (!valid) {
+        std::cout << "ERROR::COOKED_TEXTURE::INVALID_FILE: " << path << std::endl;
+        return false;
+    }
+
+    firstLevel = first;
+    lastLevel = last;
+    size_t begin = (size_t)levels[first].offset;
+    size_t end = (size_t)(levels[last].offset + levels[last].size);
+    levelOffsets.assign(levels.size(), 0);
+    levelSizes.resize(levels.size());
+    for (size_t level = 0; level < levels.size(); ++level) {
+        levelSizes[level] = (size_t)levels[level].size;
+        if ((int)level >= first && (int)level <= last)
+            levelOffsets[level] = file ? (size_t)levels[level].offset : (size_t)levels[level].offset - begin;
+    }
+
+    if (file) {
+        data.clear();
+        mapped = file;
+        return true;
+    }
+    mapped = nullptr;
+    data.resize(end - begin);
+    stream.seekg((std::streamoff)begin);
+    if (!stream.read((char*)data.data(), (std::streamsize)data.size())) {
+        std::cout << "ERROR::COOKED_TEXTURE::TRUNCATED: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CookedTexture::Save(const std::string& path) const {
+    CookedHeader header;
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.format = FORMAT_BC1;
+    header.width = (uint32_t)width;
+    header.height = (uint32_t)height;
+    header.levelCount = (uint32_t)getLevelCount();
+
+    std::vector<CookedLevel> levels(getLevelCount());
+    uint64_t offset = sizeof(header) + levels.size() * sizeof(CookedLevel);
+    for (int level = 0; level < getLevelCount(); ++level) {
+        offset = (offset + LEVEL_ALIGNMENT - 1) & ~(uint64_t)(LEVEL_ALIGNMENT - 1);
+        levels[level].offset = offset;
+        levels[level].size = levelSizes[level];
+        offset += levelSizes[level];
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)levels.data(), levels.size() * sizeof(CookedLevel));
+    static const char padding[LEVEL_ALIGNMENT] = {};
+    for (int level = 0; level < getLevelCount(); ++level) {
+        file.write(padding, (std::streamsize)(levels[level].offset - (uint64_t)file.tellp()));
+        file.write((const char*)getLevel(level), (std::streamsize)levelSizes[level]);
+    }
+    if (!file) {
+        std::cout << "ERROR::COOKED_TEXTURE::WRITE_FAILED: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CookedTexture::ReadHeader(const std::string& path, int& width, int& height) {
+    CookedHeader header;
+    AssetPack::Asset asset;
+    const AssetPack* pack = AssetPack::Mounted();
+    if (pack && pack->Find(path, asset)) {
+        if (!parseHeader(asset.data, asset.size, header))
+            return false;
+    }
+    else {
+        unsigned char bytes[sizeof(header)];
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read((char*)bytes, sizeof(bytes)) || !parseHeader(bytes, sizeof(bytes), header))
+            return false;
+    }
+    width = (int)header.width;
+    height = (int)header.height;
+    return true;
+}
+
+size_t CookedTexture::getSize() const {
+    size_t size = 0;
+    for (int level = firstLevel; level <= lastLevel; ++level)
+        size += levelSizes[level];
+    return size;
+}
+
+int CookedTexture::FindLevel(int width, int height, int levelWidth, int levelHeight) {
+    for (int level = 0; ; ++level) {
+        int w = std::max(1, width >> level), h = std::max(1, height >> level);
+        if (w == levelWidth && h == levelHeight)
+            return level;
+        if (w == 1 && h == 1)
+            return -1;
+    }
+}
+
+std::string CookedTexture::PathFor(const std::string& sourcePath) {
+    size_t dot = sourcePath.find_last_of('.');
+    size_t slash = sourcePath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return sourcePath + ".stex";
+    return sourcePath.substr(0, dot) + ".stex";
+}
@@ -0,0 +1,59 @@
+#ifndef COOKED_TEXTURE_H
+#define COOKED_TEXTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RgbImage.h"
+
+// Texture cooked offline by solarsystem_cooker: a BC1 compressed mip chain
+// that is uploaded with glCompressedTex*Image as is, with no decoding at load.
+//
+// .stex layout (little endian):
+//   char magic[4] = "STEX", uint32 version, uint32 format,
+//   uint32 width, uint32 height, uint32 levelCount,
+//   levelCount x { uint64 offset, uint64 size }   (offsets from file start)
+//   level data, each level aligned to 16 bytes
+// levelCount is the full chain down to 1x1 and the levels follow the table in
+// order; Load rejects files that break either rule.
+struct CookedTexture {
+    static const uint32_t VERSION = 1;
+    static const uint32_t FORMAT_BC1 = 1;
+
+    int width = 0, height = 0;
+    std::vector<unsigned char> data;     // Owned bytes: the loaded levels, or encoded levels
+    const unsigned char* mapped = nullptr;   // Set instead of data for files in the AssetPack
+    std::vector<size_t> levelOffsets;    // Byte offset of each level from the start of the bytes
+    std::vector<size_t> levelSizes;      // Every level of the file, loaded or not
+    int firstLevel = 0, lastLevel = -1;  // Loaded range; getLevel is only valid inside it
+
+    // Compresses every level of a mipmapped image
+    void Encode(const RgbImage& image);
+
+    // Loads levels [firstLevel, lastLevel] (-1: through the last one). Views the
+    // file in place when it is in the mounted AssetPack, otherwise reads only
+    // those levels, so single mips of a very large map can be streamed.
+    bool Load(const std::string& path, int firstLevel = 0, int lastLevel = -1);
+    bool Save(const std::string& path) const;
+
+    int getLevelCount() const { return (int)levelOffsets.size(); }
+    int getLevelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+    int getLevelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+    const unsigned char* getLevel(int level) const { return (mapped ? mapped : data.data()) + levelOffsets[level]; }
+
+    // Total bytes of the loaded levels
+    size_t getSize() const;
+
+    // Reads only the header; false if path is not a cooked texture
+    static bool ReadHeader(const std::string& path, int& width, int& height);
+
+    // Mip level of a width x height texture that is levelWidth x levelHeight, or -1
+    static int FindLevel(int width, int height, int levelWidth, int levelHeight);
+
+    // Cooked file next to a source image: assets/earth.jpg -> assets/earth.stex
+    static std::string PathFor(const std::string& sourcePath);
+};
+
+#endif
@@ -0,0 +1,39 @@
+#include "FrameUniforms.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+// Allocate the buffer and attach it to the shared binding point
+FrameUniforms::FrameUniforms() {
+    glGenBuffers(1, &UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, UBO);
+}
+
+FrameUniforms::~FrameUniforms() {
+    glDeleteBuffers(1, &UBO);
+}
+
+void FrameUniforms::SetViewport(int width, int height, float fovY, float zNear, float zFar) {
+    if (width <= 0 || height <= 0)
+        return; // Minimized window, keep the last projection
+
+    data.projection = glm::perspective(fovY, (float)width / height, zNear, zFar);
+    data.viewport = glm::vec4((float)width, (float)height, 1.0f / width, 1.0f / height);
+    dirty = true;
+}
+
+void FrameUniforms::SetView(const glm::mat4& view, const glm::vec3& cameraPosition) {
+    data.view = view;
+    data.cameraPosition = glm::vec4(cameraPosition, 1.0f);
+    dirty = true;
+}
+
+void FrameUniforms::Upload() {
+    if (!dirty)
+        return;
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), &data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    dirty = false;
+}
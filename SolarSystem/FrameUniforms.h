@@ -0,0 +1,45 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// CPU mirror of the std140 "FrameUniforms" block shared by all scene shaders
+struct FrameUniformData {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec4 cameraPosition; // xyz = world position, w unused
+    glm::vec4 viewport;       // xy = framebuffer size in pixels, zw = 1 / size
+};
+
+// Uniform buffer holding per-frame camera state. Every Shader that declares the
+// FrameUniforms block is bound to BINDING at link time, so the data is uploaded
+// once per frame no matter how many programs read it.
+class FrameUniforms {
+private:
+    GLuint UBO = 0;
+    FrameUniformData data;
+    bool dirty = true;
+
+public:
+    static const GLuint BINDING = 0;
+
+    FrameUniforms();
+    ~FrameUniforms();
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    // Rebuild the projection for a new framebuffer size (call on resize only)
+    void SetViewport(int width, int height, float fovY = glm::radians(45.0f), float zNear = 0.1f, float zFar = 1000.0f);
+
+    // Update camera matrices for this frame
+    void SetView(const glm::mat4& view, const glm::vec3& cameraPosition);
+
+    // Upload to the GPU if anything changed since the last call
+    void Upload();
+
+    const FrameUniformData& getData() const { return data; }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "Framebuffer.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+// Create color and depth attachments and check completeness
+Framebuffer::Framebuffer(int width, int height) : width(width), height(height) {
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+    glGenRenderbuffers(1, &colorRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+
+    glGenRenderbuffers(1, &depthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAMEBUFFER: Framebuffer is not complete" << std::endl;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+Framebuffer::~Framebuffer() {
+    glDeleteRenderbuffers(1, &colorRBO);
+    glDeleteRenderbuffers(1, &depthRBO);
+    glDeleteFramebuffers(1, &FBO);
+}
+
+void Framebuffer::Bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+}
+
+void Framebuffer::ReadPixels(std::vector<unsigned char>& pixels) const {
+    size_t rowSize = (size_t)width * 3;
+    pixels.resize(rowSize * height);
+
+    GLint previousAlignment;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, previousAlignment);
+
+    // OpenGL returns the bottom row first; images expect the top row first
+    for (int y = 0; y < height / 2; ++y) {
+        std::swap_ranges(pixels.begin() + y * rowSize, pixels.begin() + (y + 1) * rowSize,
+            pixels.begin() + (height - 1 - y) * rowSize);
+    }
+}
+
+bool Framebuffer::SaveToFile(const std::string& path) const {
+    std::vector<unsigned char> pixels;
+    ReadPixels(pixels);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "ERROR::FRAMEBUFFER: Could not write " << path << std::endl;
+        return false;
+    }
+    file << "P6\n" << width << " " << height << "\n255\n";
+    file.write((const char*)pixels.data(), (std::streamsize)pixels.size());
+    return (bool)file;
+}
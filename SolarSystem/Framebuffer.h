@@ -0,0 +1,34 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+// Offscreen render target: RGBA8 color + depth/stencil renderbuffers
+class Framebuffer {
+public:
+    GLuint FBO = 0;
+    int width;
+    int height;
+
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    // Render into this target (viewport is left to the caller)
+    void Bind() const;
+
+    // Reads the color buffer back as tightly packed RGB rows, top row first
+    void ReadPixels(std::vector<unsigned char>& pixels) const;
+
+    // Writes the color buffer as a binary PPM image; returns false on I/O failure
+    bool SaveToFile(const std::string& path) const;
+
+private:
+    GLuint colorRBO = 0, depthRBO = 0;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#include "Frustum.h"
+#include <cmath>
+
+// Gribb-Hartmann extraction: each plane is row 3 plus or minus row 0/1/2
+Frustum::Frustum(const glm::mat4& m) {
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0;   // Left
+    planes[1] = row3 - row0;   // Right
+    planes[2] = row3 + row1;   // Bottom
+    planes[3] = row3 - row1;   // Top
+    planes[4] = row3 + row2;   // Near
+    planes[5] = row3 - row2;   // Far
+
+    // Normalize so plane distances are in world units
+    for (glm::vec4& plane : planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane = plane * (1.0f / length);
+    }
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+// View frustum as six inward-facing planes (xyz = normal, w = distance),
+// extracted from a projection * view matrix. Used to skip bodies that are
+// entirely off screen before they are submitted for drawing.
+class Frustum {
+public:
+    glm::vec4 planes[6];
+
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    // False only if the sphere is completely outside one of the planes
+    bool IntersectsSphere(const glm::vec3& center, float radius) const;
+};
+
+#endif
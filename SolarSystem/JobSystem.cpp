@@ -0,0 +1,121 @@
+#include "JobSystem.h"
+
+// Queue index of the current thread; workers set it on start
+static thread_local int currentQueue = 0;
+static thread_local const JobSystem* currentSystem = nullptr;
+
+JobSystem::JobSystem(int workerCount) {
+    if (workerCount <= 0) {
+        int hardware = (int)std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    for (int i = 0; i <= workerCount; ++i)
+        queues.push_back(new Queue());
+    workers.reserve(workerCount);
+    for (int i = 1; i <= workerCount; ++i)
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+    for (Queue* queue : queues)
+        delete queue;
+}
+
+JobSystem& JobSystem::Get() {
+    static JobSystem system;
+    return system;
+}
+
+int JobSystem::queueIndex() const {
+    return currentSystem == this ? currentQueue : 0;
+}
+
+void JobSystem::push(const Job* jobs, int count) {
+    // Count first so queuedJobs never drops below zero when a thief is quick
+    queuedJobs.fetch_add(count);
+    Queue& queue = *queues[queueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.insert(queue.jobs.end(), jobs, jobs + count);
+    }
+
+    // Taking the sleep lock orders this with a worker checking queuedJobs before waiting
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    if (count == 1)
+        wake.notify_one();
+    else
+        wake.notify_all();
+}
+
+bool JobSystem::pop(int self, Job& job) {
+    if (queuedJobs.load() == 0)
+        return false;
+
+    // Own queue from the back (most recently pushed, still in cache)
+    {
+        Queue& queue = *queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            queuedJobs.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another queue
+    int queueCount = (int)queues.size();
+    for (int offset = 1; offset < queueCount; ++offset) {
+        Queue& queue = *queues[(self + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            queuedJobs.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(const Job& job) {
+    job.run(job.context, job.begin, job.end);
+    job.pending->fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(int index) {
+    currentQueue = index;
+    currentSystem = this;
+
+    Job job;
+    while (true) {
+        if (pop(index, job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queuedJobs.load() > 0; });
+        if (stopping && queuedJobs.load() == 0)
+            return;
+    }
+}
+
+void JobSystem::waitFor(std::atomic<int>& pending) {
+    int self = queueIndex();
+    Job job;
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (pop(self, job))
+            execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing scheduler for CPU work (simulation, transforms, culling, mesh
+// generation). Each worker owns a deque: it pushes and pops at the back and
+// idle workers steal from the front of others. Threads that are not workers
+// (the render thread) submit through a shared queue and help run jobs while
+// they wait, so ParallelFor never blocks a core. Jobs must not make GL calls;
+// only the thread that owns the context may.
+class JobSystem {
+public:
+    // Range job: run(context, begin, end); pending is decremented when it finishes
+    struct Job {
+        void (*run)(void* context, int begin, int end);
+        void* context;
+        int begin, end;
+        std::atomic<int>* pending;
+    };
+
+    // workerCount 0 uses one worker per hardware thread minus the caller
+    explicit JobSystem(int workerCount = 0);
+
+    // Finishes queued jobs and joins the workers
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Process-wide scheduler, created on first use
+    static JobSystem& Get();
+
+    // Calls fn(rangeBegin, rangeEnd) over [begin, end) split into chunks of at
+    // least grain items, in parallel, and returns when every chunk is done.
+    // Ranges smaller than grain run inline on the calling thread.
+    template <typename Fn>
+    void ParallelFor(int begin, int end, int grain, const Fn& fn);
+
+    // Number of worker threads (the calling thread runs jobs too)
+    int getWorkerCount() const { return (int)workers.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<Queue*> queues;          // queues[0] is shared by non-worker threads
+    std::atomic<int> queuedJobs{ 0 };    // Jobs waiting in any queue
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    // Queue of the calling thread (0 for non-workers)
+    int queueIndex() const;
+
+    // Queues chunks and wakes sleeping workers
+    void push(const Job* jobs, int count);
+
+    // Takes a job from the thread's own queue, else steals one; false if all are empty
+    bool pop(int self, Job& job);
+
+    static void execute(const Job& job);
+    void workerLoop(int index);
+
+    // Runs jobs until pending reaches zero
+    void waitFor(std::atomic<int>& pending);
+};
+
+template <typename Fn>
+void JobSystem::ParallelFor(int begin, int end, int grain, const Fn& fn) {
+    int count = end - begin;
+    if (count <= 0)
+        return;
+
+    // Enough chunks to balance load across threads, but never below grain
+    int threads = getWorkerCount() + 1;
+    int chunk = count / (threads * 4);
+    if (chunk < grain)
+        chunk = grain < 1 ? 1 : grain;
+    if (threads == 1 || count <= chunk) {
+        fn(begin, end);
+        return;
+    }
+
+    int chunkCount = (count + chunk - 1) / chunk;
+    std::atomic<int> pending{ chunkCount - 1 };
+    auto run = [](void* context, int rangeBegin, int rangeEnd) {
+        (*static_cast<const Fn*>(context))(rangeBegin, rangeEnd);
+    };
+
+    std::vector<Job> jobs;
+    jobs.reserve(chunkCount - 1);
+    for (int i = 1; i < chunkCount; ++i) {
+        int rangeBegin = begin + i * chunk;
+        int rangeEnd = rangeBegin + chunk < end ? rangeBegin + chunk : end;
+        jobs.push_back({ run, (void*)&fn, rangeBegin, rangeEnd, &pending });
+    }
+    push(jobs.data(), (int)jobs.size());
+
+    // First chunk on this thread, then help with the rest
+    fn(begin, begin + chunk);
+    waitFor(pending);
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include "Kepler.h"
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <math.h>
+
+#include "JobSystem.h"
+#include "SimdMath.h"
+
+OrbitalElements OrbitalElements::Circular(float radius, float meanMotion) {
+    OrbitalElements elements;
+    elements.semiMajorAxis = radius;
+    elements.meanMotion = meanMotion;
+    return elements;
+}
+
+// Perifocal frame rotated by node, inclination and periapsis, then mapped from
+// ecliptic (x, y, z-up) to scene axes (x, z-up, -y)
+void OrbitalElements::GetBasis(glm::vec3& P, glm::vec3& Q) const {
+    float cosNode = cosf(ascendingNode), sinNode = sinf(ascendingNode);
+    float cosPeri = cosf(periapsis), sinPeri = sinf(periapsis);
+    float cosInc = cosf(inclination), sinInc = sinf(inclination);
+
+    glm::vec3 p(cosNode * cosPeri - sinNode * sinPeri * cosInc,
+                sinNode * cosPeri + cosNode * sinPeri * cosInc,
+                sinPeri * sinInc);
+    glm::vec3 q(-cosNode * sinPeri - sinNode * cosPeri * cosInc,
+                -sinNode * sinPeri + cosNode * cosPeri * cosInc,
+                cosPeri * sinInc);
+    P = glm::vec3(p.x, p.z, -p.y);
+    Q = glm::vec3(q.x, q.z, -q.y);
+}
+
+float OrbitalElements::MeanAnomalyAt(double t) const {
+    double m = meanAnomaly + meanMotion * t;
+    m -= 2.0 * M_PI * std::floor((m + M_PI) / (2.0 * M_PI));
+    return (float)m;
+}
+
+glm::vec3 OrbitalElements::PositionAtAnomaly(float E) const {
+    glm::vec3 P, Q;
+    GetBasis(P, Q);
+    float b = semiMajorAxis * std::sqrt(1.0f - eccentricity * eccentricity);
+    return P * (semiMajorAxis * (cosf(E) - eccentricity)) + Q * (b * sinf(E));
+}
+
+glm::vec3 OrbitalElements::PositionAt(double t) const {
+    return PositionAtAnomaly(SolveKepler(MeanAnomalyAt(t), eccentricity));
+}
+
+glm::vec3 OrbitalElements::DirectionAt(double t) const {
+    glm::vec3 P, Q;
+    GetBasis(P, Q);
+    float E = SolveKepler(MeanAnomalyAt(t), eccentricity);
+    float b = semiMajorAxis * std::sqrt(1.0f - eccentricity * eccentricity);
+    glm::vec3 velocity = P * (-semiMajorAxis * sinf(E)) + Q * (b * cosf(E));
+    float length = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+    if (length <= 0.0f)
+        return glm::vec3(0.0f);
+    return velocity * ((meanMotion < 0.0f ? -1.0f : 1.0f) / length);
+}
+
+// Worst case over M in float from the second-order start below; kepler.vs
+// uses the same table
+int KeplerIterations(float e) {
+    return e <= 0.3f ? 1 : (e <= 0.85f ? 2 : (e <= 0.98f ? 3 : 4));
+}
+
+// Start from the second-order series E = M + e sin M (1 + e cos M); Halley's
+// method then converges cubically. The denominator is kept at least f'^2 / 2,
+// so a step far from the root is at most twice Newton's instead of blowing up.
+float SolveKepler(float M, float e, int iterations) {
+    e = std::min(std::max(e, 0.0f), MAX_ECCENTRICITY);
+    if (iterations < 0)
+        iterations = KeplerIterations(e);
+    float E = M + e * sinf(M) * (1.0f + e * cosf(M));
+    for (int k = 0; k < iterations; ++k) {
+        float s = sinf(E), c = cosf(E);
+        float f = E - e * s - M;
+        float f1 = 1.0f - e * c;
+        E -= f * f1 / std::max(f1 * f1 - 0.5f * f * e * s, 0.5f * f1 * f1);
+    }
+    return E;
+}
+
+int KeplerBatch::Add(const OrbitalElements& elements) {
+    int index = count++;
+    size_t padded = ((size_t)count + PADDING - 1) / PADDING * PADDING;
+    if (padded != meanAnomaly.size()) {
+        // Padding bodies sit at the origin (a = 0)
+        for (std::vector<float>* array : { &meanAnomaly, &meanMotion, &eccentricity, &semiMajor, &semiMinor,
+                                           &px, &py, &pz, &qx, &qy, &qz })
+            array->resize(padded, 0.0f);
+    }
+
+    glm::vec3 P, Q;
+    elements.GetBasis(P, Q);
+    float e = std::min(std::max(elements.eccentricity, 0.0f), MAX_ECCENTRICITY);
+    meanAnomaly[index] = elements.meanAnomaly;
+    meanMotion[index] = elements.meanMotion;
+    eccentricity[index] = e;
+    semiMajor[index] = elements.semiMajorAxis;
+    semiMinor[index] = elements.semiMajorAxis * std::sqrt(1.0f - e * e);
+    px[index] = P.x; py[index] = P.y; pz[index] = P.z;
+    qx[index] = Q.x; qy[index] = Q.y; qz[index] = Q.z;
+
+    blockIterations.resize(padded / PADDING, 1);
+    blockIterations[index / PADDING] = std::max(blockIterations[index / PADDING], KeplerIterations(e));
+    return index;
+}
+
+void KeplerBatch::Clear() {
+    for (std::vector<float>* array : { &meanAnomaly, &meanMotion, &eccentricity, &semiMajor, &semiMinor,
+                                       &px, &py, &pz, &qx, &qy, &qz })
+        array->clear();
+    blockIterations.clear();
+    count = 0;
+}
+
+void KeplerBatch::Propagate(double t, float* x, float* y, float* z, int stride) const {
+    JobSystem::Get().ParallelFor(0, count, 4096, [&](int begin, int end) {
+        PropagateRange(t, begin, end, x, y, z, stride);
+    });
+}
+
+void KeplerBatch::PropagateRange(double t, int begin, int end, float* x, float* y, float* z, int stride) const {
+    using namespace simd;
+
+    // Blocks of WIDTH bodies; the padded arrays make partial blocks safe to read
+    for (int block = begin - begin % WIDTH; block < end; block += WIDTH) {
+        const Float M = MeanAnomaly(&meanAnomaly[block], &meanMotion[block], t);
+        const Float e = Load(&eccentricity[block]);
+        const Float one = Set(1.0f);
+
+        Float s, c;
+        SinCos(M, s, c);
+        Float E = MulAdd(Mul(e, s), MulAdd(e, c, one), M);
+        const int iterations = blockIterations[block / PADDING];
+        for (int k = 0; k < iterations; ++k) {
+            // Halley step f f' / (f'^2 - f f'' / 2) with a single division,
+            // the denominator kept at least f'^2 / 2 as in SolveKepler
+            SinCos(E, s, c);
+            Float es = Mul(e, s);
+            Float f = Sub(Sub(E, es), M);
+            Float f1 = Sub(one, Mul(e, c));
+            Float f1Squared = Mul(f1, f1);
+            Float least = Mul(Set(0.5f), f1Squared);
+            Float denominator = Sub(f1Squared, Mul(Set(0.5f), Mul(f, es)));
+            denominator = Select(Less(denominator, least), least, denominator);
+            E = Sub(E, Div(Mul(f, f1), denominator));
+        }
+        SinCos(E, s, c);
+
+        const Float u = Mul(Load(&semiMajor[block]), Sub(c, e));
+        const Float v = Mul(Load(&semiMinor[block]), s);
+        float outX[WIDTH], outY[WIDTH], outZ[WIDTH];
+        Store(outX, MulAdd(u, Load(&px[block]), Mul(v, Load(&qx[block]))));
+        Store(outY, MulAdd(u, Load(&py[block]), Mul(v, Load(&qy[block]))));
+        Store(outZ, MulAdd(u, Load(&pz[block]), Mul(v, Load(&qz[block]))));
+
+        for (int lane = 0; lane < WIDTH; ++lane) {
+            int i = block + lane;
+            if (i < begin || i >= end)
+                continue;
+            x[(size_t)i * stride] = outX[lane];
+            y[(size_t)i * stride] = outY[lane];
+            z[(size_t)i * stride] = outZ[lane];
+        }
+    }
+}
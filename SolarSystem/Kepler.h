@@ -0,0 +1,82 @@
+#ifndef KEPLER_H
+#define KEPLER_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Classical orbital elements around a body at the origin. The reference plane
+// is the scene's XZ plane (Y up); with i = node = periapsis = 0 a circular
+// orbit reproduces the old motion (r cos M, 0, -r sin M). Angles in radians.
+struct OrbitalElements {
+    float semiMajorAxis = 0.0f;   // a
+    float eccentricity = 0.0f;    // e, 0 <= e <= MAX_ECCENTRICITY
+    float inclination = 0.0f;     // i, tilt against the XZ plane
+    float ascendingNode = 0.0f;   // Longitude of the ascending node
+    float periapsis = 0.0f;       // Argument of periapsis
+    float meanAnomaly = 0.0f;     // M0, mean anomaly at t = 0
+    float meanMotion = 0.0f;      // n, radians per second
+
+    // Circle in the XZ plane, as the original Orbit/Planet pair modelled
+    static OrbitalElements Circular(float radius, float meanMotion);
+
+    // Unit vectors towards periapsis (P) and 90 degrees ahead of it in the orbit plane (Q)
+    void GetBasis(glm::vec3& P, glm::vec3& Q) const;
+
+    // M0 + n t wrapped to [-pi, pi)
+    float MeanAnomalyAt(double t) const;
+
+    // Position for an eccentric anomaly
+    glm::vec3 PositionAtAnomaly(float eccentricAnomaly) const;
+
+    glm::vec3 PositionAt(double t) const;
+
+    // Unit direction of travel at time t
+    glm::vec3 DirectionAt(double t) const;
+};
+
+// Most eccentric orbit the float solver is verified for: KeplerIterations
+// reaches a 2e-6 rad solution up to it. Larger eccentricities are clamped.
+const float MAX_ECCENTRICITY = 0.995f;
+
+// Halley steps SolveKepler needs from its start for an eccentricity
+int KeplerIterations(float eccentricity);
+
+// Solves Kepler's equation M = E - e sin E for E with Halley iterations,
+// KeplerIterations(e) of them by default
+float SolveKepler(float meanAnomaly, float eccentricity, int iterations = -1);
+
+// Closed-form propagation of many bodies, stored as structure of arrays and
+// solved SIMD-wide (see SimdMath.h) across the job system. Precomputes each
+// orbit's basis so a body costs a few sincos and multiply-adds per call, and
+// runs only as many Halley steps as the most eccentric orbit in its block needs.
+class KeplerBatch {
+public:
+    static const int PADDING = 8;   // Arrays are padded to this many bodies
+
+    // Adds a body and returns its index
+    int Add(const OrbitalElements& elements);
+
+    void Clear();
+
+    int getCount() const { return count; }
+
+    // Writes positions at time t for every body. Body i goes to x[i * stride],
+    // y[i * stride], z[i * stride], so SoA arrays and interleaved vertices both work.
+    void Propagate(double t, float* x, float* y, float* z, int stride = 1) const;
+
+    // Same for bodies [begin, end) on the calling thread
+    void PropagateRange(double t, int begin, int end, float* x, float* y, float* z, int stride = 1) const;
+
+private:
+    friend class KeplerFeedback;   // Uploads the same arrays for the GPU solver
+
+    int count = 0;
+    std::vector<float> meanAnomaly, meanMotion;   // M0, n
+    std::vector<float> eccentricity;
+    std::vector<float> semiMajor, semiMinor;      // a, b = a sqrt(1 - e^2)
+    std::vector<float> px, py, pz;                // Periapsis direction
+    std::vector<float> qx, qy, qz;                // In-plane normal to it
+    std::vector<int> blockIterations;             // Halley steps per PADDING bodies
+};
+
+#endif
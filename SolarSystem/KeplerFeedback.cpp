@@ -0,0 +1,80 @@
+#include "KeplerFeedback.h"
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstddef>
+#include <math.h>
+#include <vector>
+
+// Splits x into a part with at most 12 significant bits and the rest. A 12-bit
+// by 12-bit product is exact in float, so fract() of it loses no whole turns.
+static void splitHigh(double x, float& high, float& low) {
+    int exponent;
+    std::frexp(x, &exponent);
+    double step = std::ldexp(1.0, exponent - 12);
+    double rounded = std::trunc(x / step) * step;
+    high = (float)rounded;
+    low = (float)(x - rounded);
+}
+
+KeplerFeedback::KeplerFeedback(const KeplerBatch& orbits)
+    : shader("kepler.vs", std::vector<std::string>{ "position" }), count(orbits.getCount())
+{
+    timeHighLoc = shader.getUniformLocation("timeHigh");
+    timeLowLoc = shader.getUniformLocation("timeLow");
+
+    std::vector<GpuOrbit> vertices(count);
+    for (int i = 0; i < count; ++i) {
+        GpuOrbit& vertex = vertices[i];
+        vertex.meanAnomaly = (float)(orbits.meanAnomaly[i] / (2.0 * M_PI));
+        splitHigh(orbits.meanMotion[i] / (2.0 * M_PI), vertex.motionHigh, vertex.motionLow);
+        vertex.eccentricity = orbits.eccentricity[i];
+        vertex.majorAxis[0] = orbits.semiMajor[i] * orbits.px[i];
+        vertex.majorAxis[1] = orbits.semiMajor[i] * orbits.py[i];
+        vertex.majorAxis[2] = orbits.semiMajor[i] * orbits.pz[i];
+        vertex.minorAxis[0] = orbits.semiMinor[i] * orbits.qx[i];
+        vertex.minorAxis[1] = orbits.semiMinor[i] * orbits.qy[i];
+        vertex.minorAxis[2] = orbits.semiMinor[i] * orbits.qz[i];
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertices.size() * sizeof(GpuOrbit), vertices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(GpuOrbit), (void*)offsetof(GpuOrbit, meanAnomaly));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(GpuOrbit), (void*)offsetof(GpuOrbit, majorAxis));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(GpuOrbit), (void*)offsetof(GpuOrbit, minorAxis));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+}
+
+KeplerFeedback::~KeplerFeedback() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+}
+
+void KeplerFeedback::Propagate(double t, GLuint output) {
+    if (count == 0)
+        return;
+
+    // The mean anomaly is n t in turns; with t split like n the shader can drop
+    // whole turns exactly and keeps full float precision however large t gets
+    float timeHigh, timeLow;
+    splitHigh(t, timeHigh, timeLow);
+    shader.Use();
+    shader.setFloat(timeHighLoc, timeHigh);
+    shader.setFloat(timeLowLoc, timeLow);
+
+    // Vertex stage only: every orbit is one point, nothing is rasterized
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, output);
+    glBindVertexArray(VAO);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, count);
+    glEndTransformFeedback();
+    glBindVertexArray(0);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+}
@@ -0,0 +1,44 @@
+#ifndef KEPLER_FEEDBACK_H
+#define KEPLER_FEEDBACK_H
+
+#include <glad/glad.h>
+#include "Kepler.h"
+#include "Shader.h"
+
+// GPU counterpart of KeplerBatch: the orbits are uploaded once as vertex
+// attributes and kepler.vs solves Kepler's equation per vertex, with transform
+// feedback capturing the positions into a vertex buffer the caller draws from.
+// Per frame the CPU only sets two uniforms and issues one draw, which suits
+// populations that are only ever looked at (nothing reads positions back).
+class KeplerFeedback {
+public:
+    explicit KeplerFeedback(const KeplerBatch& orbits);
+    ~KeplerFeedback();
+
+    KeplerFeedback(const KeplerFeedback&) = delete;
+    KeplerFeedback& operator=(const KeplerFeedback&) = delete;
+
+    // Writes getCount() tightly packed vec3 positions at time t into output,
+    // which must hold at least getCount() * 12 bytes. Changes the bound program.
+    void Propagate(double t, GLuint output);
+
+    int getCount() const { return count; }
+
+private:
+    // Vertex layout of kepler.vs (locations 0-2)
+    struct GpuOrbit {
+        float meanAnomaly;        // M0 in turns
+        float motionHigh;         // n in turns per second, leading 12 bits
+        float motionLow;          // and the remainder
+        float eccentricity;
+        float majorAxis[3];       // a * P
+        float minorAxis[3];       // b * Q
+    };
+
+    Shader shader;
+    GLuint VAO = 0, VBO = 0;
+    int count = 0;
+    GLint timeHighLoc = -1, timeLowLoc = -1;
+};
+
+#endif
@@ -0,0 +1,223 @@
+#include "NBody.h"
+#include <cmath>
+
+#include "JobSystem.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NBODY_AVX2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NBODY_NEON 1
+#endif
+
+int NBodySystem::AddBody(const glm::vec3& position, const glm::vec3& velocity, float bodyMass) {
+    int index = count++;
+    size_t padded = ((size_t)count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    if (padded != px.size()) {
+        // Padding bodies are massless and at rest at the origin
+        for (std::vector<float>* array : { &px, &py, &pz, &vx, &vy, &vz, &ax, &ay, &az, &mass })
+            array->resize(padded, 0.0f);
+    }
+    px[index] = position.x; py[index] = position.y; pz[index] = position.z;
+    vx[index] = velocity.x; vy[index] = velocity.y; vz[index] = velocity.z;
+    mass[index] = bodyMass;
+    accelerationsValid = false;
+    return index;
+}
+
+void NBodySystem::Clear() {
+    for (std::vector<float>* array : { &px, &py, &pz, &vx, &vy, &vz, &ax, &ay, &az, &mass })
+        array->clear();
+    count = 0;
+    accelerationsValid = false;
+}
+
+const char* NBodySystem::KernelName() {
+#if defined(NBODY_AVX2)
+    return "AVX2";
+#elif defined(NBODY_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void NBodySystem::ComputeAccelerations() {
+    if (backend == ForceBackend::BarnesHut) {
+        tree.Build(px.data(), py.data(), pz.data(), mass.data(), count);
+        tree.ComputeAccelerations(G, softening, ax.data(), ay.data(), az.data());
+        return;
+    }
+
+    // Each target body reads every source body, so rows split freely across threads
+    JobSystem::Get().ParallelFor(0, count, 64, [this](int begin, int end) {
+        accelerationsSimd(begin, end);
+    });
+}
+
+void NBodySystem::ComputeAccelerationsScalar() {
+    JobSystem::Get().ParallelFor(0, count, 64, [this](int begin, int end) {
+        accelerationsScalar(begin, end);
+    });
+}
+
+// a_i = G * sum_j m_j * (p_j - p_i) / (|p_j - p_i|^2 + eps^2)^(3/2)
+// The j == i term vanishes because its displacement is zero.
+void NBodySystem::accelerationsScalar(int begin, int end) {
+    const int n = (int)px.size();
+    const float eps2 = softening * softening;
+
+    for (int i = begin; i < end; ++i) {
+        const float xi = px[i], yi = py[i], zi = pz[i];
+        float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+        for (int j = 0; j < n; ++j) {
+            float dx = px[j] - xi;
+            float dy = py[j] - yi;
+            float dz = pz[j] - zi;
+            float r2 = dx * dx + dy * dy + dz * dz + eps2;
+            float inv = 1.0f / std::sqrt(r2);
+            float s = mass[j] * inv * inv * inv;
+            sx += dx * s;
+            sy += dy * s;
+            sz += dz * s;
+        }
+        ax[i] = G * sx;
+        ay[i] = G * sy;
+        az[i] = G * sz;
+    }
+}
+
+#if defined(NBODY_AVX2)
+
+static inline __m256 fmadd(__m256 a, __m256 b, __m256 c) {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+static inline float horizontalSum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+// Eight source bodies per iteration; rsqrt refined by one Newton step (~23 bits)
+void NBodySystem::accelerationsSimd(int begin, int end) {
+    const int n = (int)px.size();
+    const __m256 eps2 = _mm256_set1_ps(softening * softening);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+
+    for (int i = begin; i < end; ++i) {
+        const __m256 xi = _mm256_set1_ps(px[i]);
+        const __m256 yi = _mm256_set1_ps(py[i]);
+        const __m256 zi = _mm256_set1_ps(pz[i]);
+        __m256 sx = _mm256_setzero_ps(), sy = _mm256_setzero_ps(), sz = _mm256_setzero_ps();
+
+        for (int j = 0; j < n; j += SIMD_WIDTH) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&px[j]), xi);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&py[j]), yi);
+            __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&pz[j]), zi);
+            __m256 r2 = fmadd(dx, dx, fmadd(dy, dy, fmadd(dz, dz, eps2)));
+
+            __m256 inv = _mm256_rsqrt_ps(r2);
+            __m256 r2Half = _mm256_mul_ps(half, r2);
+            inv = _mm256_mul_ps(inv, _mm256_sub_ps(threeHalves, _mm256_mul_ps(r2Half, _mm256_mul_ps(inv, inv))));
+
+            __m256 s = _mm256_mul_ps(_mm256_loadu_ps(&mass[j]), _mm256_mul_ps(inv, _mm256_mul_ps(inv, inv)));
+            sx = fmadd(dx, s, sx);
+            sy = fmadd(dy, s, sy);
+            sz = fmadd(dz, s, sz);
+        }
+        ax[i] = G * horizontalSum(sx);
+        ay[i] = G * horizontalSum(sy);
+        az[i] = G * horizontalSum(sz);
+    }
+}
+
+#elif defined(NBODY_NEON)
+
+// Four lanes per vector, two vectors per iteration to match SIMD_WIDTH
+void NBodySystem::accelerationsSimd(int begin, int end) {
+    const int n = (int)px.size();
+    const float32x4_t eps2 = vdupq_n_f32(softening * softening);
+
+    for (int i = begin; i < end; ++i) {
+        const float32x4_t xi = vdupq_n_f32(px[i]);
+        const float32x4_t yi = vdupq_n_f32(py[i]);
+        const float32x4_t zi = vdupq_n_f32(pz[i]);
+        float32x4_t sx = vdupq_n_f32(0.0f), sy = vdupq_n_f32(0.0f), sz = vdupq_n_f32(0.0f);
+
+        for (int j = 0; j < n; j += 4) {
+            float32x4_t dx = vsubq_f32(vld1q_f32(&px[j]), xi);
+            float32x4_t dy = vsubq_f32(vld1q_f32(&py[j]), yi);
+            float32x4_t dz = vsubq_f32(vld1q_f32(&pz[j]), zi);
+            float32x4_t r2 = vmlaq_f32(vmlaq_f32(vmlaq_f32(eps2, dz, dz), dy, dy), dx, dx);
+
+            // Reciprocal square root estimate plus two Newton-Raphson steps
+            float32x4_t inv = vrsqrteq_f32(r2);
+            inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(r2, inv), inv));
+            inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(r2, inv), inv));
+
+            float32x4_t s = vmulq_f32(vld1q_f32(&mass[j]), vmulq_f32(inv, vmulq_f32(inv, inv)));
+            sx = vmlaq_f32(sx, dx, s);
+            sy = vmlaq_f32(sy, dy, s);
+            sz = vmlaq_f32(sz, dz, s);
+        }
+        float32x2_t hx = vadd_f32(vget_low_f32(sx), vget_high_f32(sx));
+        float32x2_t hy = vadd_f32(vget_low_f32(sy), vget_high_f32(sy));
+        float32x2_t hz = vadd_f32(vget_low_f32(sz), vget_high_f32(sz));
+        ax[i] = G * vget_lane_f32(vpadd_f32(hx, hx), 0);
+        ay[i] = G * vget_lane_f32(vpadd_f32(hy, hy), 0);
+        az[i] = G * vget_lane_f32(vpadd_f32(hz, hz), 0);
+    }
+}
+
+#else
+
+void NBodySystem::accelerationsSimd(int begin, int end) {
+    accelerationsScalar(begin, end);
+}
+
+#endif
+
+void NBodySystem::Step(float dt) {
+    if (!accelerationsValid)
+        ComputeAccelerations();
+
+    const float halfDt = 0.5f * dt;
+    for (int i = 0; i < count; ++i) {
+        // Kick (half step) then drift
+        vx[i] += ax[i] * halfDt; vy[i] += ay[i] * halfDt; vz[i] += az[i] * halfDt;
+        px[i] += vx[i] * dt;     py[i] += vy[i] * dt;     pz[i] += vz[i] * dt;
+    }
+
+    ComputeAccelerations();
+
+    for (int i = 0; i < count; ++i) {
+        // Second half kick with the new accelerations
+        vx[i] += ax[i] * halfDt; vy[i] += ay[i] * halfDt; vz[i] += az[i] * halfDt;
+    }
+    accelerationsValid = true;
+}
+
+void NBodySystem::RemoveNetMomentum() {
+    double totalMass = 0.0, momentumX = 0.0, momentumY = 0.0, momentumZ = 0.0;
+    for (int i = 0; i < count; ++i) {
+        totalMass += mass[i];
+        momentumX += (double)mass[i] * vx[i];
+        momentumY += (double)mass[i] * vy[i];
+        momentumZ += (double)mass[i] * vz[i];
+    }
+    if (totalMass <= 0.0)
+        return;
+    for (int i = 0; i < count; ++i) {
+        vx[i] -= (float)(momentumX / totalMass);
+        vy[i] -= (float)(momentumY / totalMass);
+        vz[i] -= (float)(momentumZ / totalMass);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef NBODY_H
+#define NBODY_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "BarnesHut.h"
+
+// Direct-sum O(N^2) gravity over bodies stored as structure of arrays.
+// Arrays are padded to a multiple of SIMD_WIDTH with massless bodies so the
+// vector kernels (AVX2 on x86, NEON on ARM, chosen at compile time) never need
+// a remainder loop; a scalar kernel is always available as the fallback.
+// Large systems can switch to the Barnes-Hut backend instead of the direct sum.
+class NBodySystem {
+public:
+    static const int SIMD_WIDTH = 8;
+
+    enum class ForceBackend {
+        DirectSum,   // Exact O(N^2), SIMD kernel
+        BarnesHut    // Approximate O(N log N), opening angle in tree.theta
+    };
+
+    // Positions, velocities, accelerations and masses; index i is one body
+    std::vector<float> px, py, pz;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> ax, ay, az;
+    std::vector<float> mass;
+
+    float G = 1.0f;
+    float softening = 0.05f;   // Plummer softening length, must be > 0
+
+    ForceBackend backend = ForceBackend::DirectSum;
+    BarnesHutTree tree;        // Rebuilt every ComputeAccelerations with BarnesHut
+
+    // Adds a body and returns its index
+    int AddBody(const glm::vec3& position, const glm::vec3& velocity, float bodyMass);
+
+    // Removes every body
+    void Clear();
+
+    int getCount() const { return count; }
+
+    glm::vec3 getPosition(int i) const { return glm::vec3(px[i], py[i], pz[i]); }
+    glm::vec3 getVelocity(int i) const { return glm::vec3(vx[i], vy[i], vz[i]); }
+
+    // Fills ax/ay/az using the selected backend (direct sum: best kernel compiled in),
+    // split across the job system
+    void ComputeAccelerations();
+
+    // Reference kernel, also used when no SIMD instruction set is enabled
+    void ComputeAccelerationsScalar();
+
+    // One kick-drift-kick leapfrog step (second order, symplectic)
+    void Step(float dt);
+
+    // Shifts velocities so the total momentum is zero (keeps the system centered)
+    void RemoveNetMomentum();
+
+    // Name of the direct-sum kernel ("AVX2", "NEON" or "scalar")
+    static const char* KernelName();
+
+private:
+    int count = 0;
+    bool accelerationsValid = false;   // ax/ay/az match the current positions
+
+    // Accelerations of bodies [begin, end) from every body
+    void accelerationsScalar(int begin, int end);
+    void accelerationsSimd(int begin, int end);
+};
+
+#endif
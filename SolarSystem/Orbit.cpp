@@ -1,46 +1,52 @@
 #include "Orbit.h"
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include <math.h>
 
-// Generate circular orbit vertices and set up VAO/VBO
-Orbit::Orbit(float radius, int segments) : radius(radius) {
-    float angleStep = 2.0f * M_PI / segments;
+Orbit::Orbit(float radius) : Orbit(OrbitalElements::Circular(radius, 0.0f)) {}
 
-    for (int i = 0; i <= segments; ++i) {
-        float angle = i * angleStep;
-        float x = radius * cosf(angle);
-        float z = radius * sinf(angle);
-        vertices.push_back(x);
-        vertices.push_back(0.0f);
-        vertices.push_back(z);
-    }
+Orbit::Orbit(const OrbitalElements& elements) : elements(elements) {}
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+// A chord spanning 2 pi / N of a circle of radius r deviates from it by about
+// r pi^2 / (2 N^2). Projected at the orbit's closest possible distance that
+// must stay below maxError pixels, so N = pi sqrt(r s / (2 d maxError)).
+int Orbit::RequiredLevel(const glm::vec3& cameraPosition, float pixelScale, float maxError) const {
+    float a = elements.semiMajorAxis;
+    if (a <= 0.0f)
+        return 0;
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
-}
+    // The orbit lies within a * (1 + e) of its focus; once the camera is inside
+    // that sphere the nearest part of the path can be arbitrarily close, so
+    // assume a tenth of the orbit size instead of zero
+    float apoapsis = a * (1.0f + elements.eccentricity);
+    float distance = std::max(glm::length(cameraPosition) - apoapsis, 0.1f * a);
+    float segments = (float)M_PI * std::sqrt(apoapsis * pixelScale / (2.0f * distance * maxError));
 
-// Delete buffers
-Orbit::~Orbit() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    int level = 0;
+    while (level + 1 < LOD_LEVELS && SegmentsForLevel(level) < segments)
+        ++level;
+    return level;
 }
 
-// Draw the orbit
-void Orbit::Draw() const {
-    if (VAO == 0) return;
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_LINE_LOOP, 0, vertices.size() / 3);
-    glBindVertexArray(0);
+// Generate the level's vertices from the elements on first use
+const std::vector<float>& Orbit::getVertices(int level) const {
+    std::vector<float>& vertices = levels[level];
+    if (!vertices.empty())
+        return vertices;
+
+    int segments = SegmentsForLevel(level);
+    float angleStep = 2.0f * M_PI / segments;
+    vertices.reserve((size_t)segments * 3);
+    for (int i = 0; i < segments; ++i) {
+        glm::vec3 position = elements.PositionAtAnomaly(i * angleStep);
+        vertices.push_back(position.x);
+        vertices.push_back(position.y);
+        vertices.push_back(position.z);
+    }
+    return vertices;
 }
 
 float Orbit::getRadius() const {
-    return radius;
+    return elements.semiMajorAxis;
 }
@@ -1,27 +1,46 @@
 #ifndef ORBIT_H
 #define ORBIT_H
 
-#include <glad/glad.h>
+#include <glm/glm.hpp>
 #include <vector>
+#include "Kepler.h"
 
+// Closed polyline of an orbit at several levels of detail. Level l has
+// MIN_SEGMENTS << l segments; levels are generated on first use and kept.
+// Holds no GL objects; OrbitBatch concatenates the polylines of every orbit
+// into one buffer and draws them together.
 class Orbit {
+public:
+    static const int MIN_SEGMENTS = 16;
+    static const int LOD_LEVELS = 7;      // 16 to 1024 segments
+
 private:
-    GLuint VAO = 0, VBO = 0;
-    std::vector<float> vertices; 
-    float radius;
+    OrbitalElements elements;
+    mutable std::vector<float> levels[LOD_LEVELS];   // xyz per vertex, empty until requested
 
 public:
     // Creates orbit path as a circle in XZ plane
-    Orbit(float radius, int segments = 100);
+    explicit Orbit(float radius);
+
+    // Creates orbit path as the ellipse described by the elements (same model
+    // the simulation propagates), sampled evenly in eccentric anomaly
+    explicit Orbit(const OrbitalElements& elements);
 
-    // Releases OpenGL buffers
-    ~Orbit();
+    static int SegmentsForLevel(int level) { return MIN_SEGMENTS << level; }
 
-    // Renders the orbit using GL_LINE_LOOP
-    void Draw() const;
+    // Lowest level whose chords stay within maxError pixels of the ellipse when
+    // seen from cameraPosition (relative to the focus); pixelScale is the projection's pixels per unit
+    // at distance 1 (viewport height / (2 tan(fovY / 2)))
+    int RequiredLevel(const glm::vec3& cameraPosition, float pixelScale, float maxError = 0.5f) const;
 
-    // Getter for orbit radius
+    // Vertex positions of a level, xyz per vertex, drawn as a GL_LINE_LOOP
+    const std::vector<float>& getVertices(int level) const;
+    int getVertexCount(int level) const { return SegmentsForLevel(level); }
+
+    // Getter for orbit radius (semi-major axis)
     float getRadius() const;
+
+    const OrbitalElements& getElements() const { return elements; }
 };
 
 #endif
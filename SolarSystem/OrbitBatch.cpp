@@ -0,0 +1,79 @@
+#include "OrbitBatch.h"
+#include <cstddef>
+
+OrbitBatch::OrbitBatch() {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(OrbitVertex), (void*)offsetof(OrbitVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(OrbitVertex), (void*)offsetof(OrbitVertex, color));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+}
+
+OrbitBatch::~OrbitBatch() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+}
+
+void OrbitBatch::Clear() {
+    entries.clear();
+    dirty = true;
+}
+
+int OrbitBatch::Add(const Orbit& orbit, const glm::vec3& color) {
+    entries.push_back({ &orbit, color, DEFAULT_LEVEL });
+    dirty = true;
+    return (int)entries.size() - 1;
+}
+
+void OrbitBatch::UpdateLevels(const glm::vec3& cameraPosition, float pixelScale) {
+    for (Entry& entry : entries) {
+        int level = entry.orbit->RequiredLevel(cameraPosition, pixelScale);
+        if (level != entry.level) {
+            entry.level = level;
+            dirty = true;
+        }
+    }
+}
+
+void OrbitBatch::rebuild() {
+    vertices.clear();
+    firsts.clear();
+    counts.clear();
+    for (const Entry& entry : entries) {
+        // Levels are cached by the orbit, so switching back is only a copy
+        const std::vector<float>& positions = entry.orbit->getVertices(entry.level);
+        firsts.push_back((GLint)vertices.size());
+        counts.push_back((GLsizei)entry.orbit->getVertexCount(entry.level));
+        for (size_t i = 0; i + 2 < positions.size(); i += 3)
+            vertices.push_back({ glm::vec3(positions[i], positions[i + 1], positions[i + 2]), entry.color });
+    }
+
+    // Grow the buffer when needed, otherwise orphan it and refill
+    GLsizeiptr size = (GLsizeiptr)(vertices.size() * sizeof(OrbitVertex));
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (size > capacity) {
+        capacity = size;
+        glBufferData(GL_ARRAY_BUFFER, capacity, vertices.data(), GL_DYNAMIC_DRAW);
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices.data());
+    }
+    dirty = false;
+}
+
+void OrbitBatch::Draw() {
+    if (dirty)
+        rebuild();
+    if (counts.empty())
+        return;
+
+    glBindVertexArray(VAO);
+    glMultiDrawArrays(GL_LINE_LOOP, firsts.data(), counts.data(), (GLsizei)counts.size());
+    glBindVertexArray(0);
+}
@@ -0,0 +1,68 @@
+#ifndef ORBIT_BATCH_H
+#define ORBIT_BATCH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Orbit.h"
+
+// Per-vertex data of orbit.vs (attribute locations 0-1)
+struct OrbitVertex {
+    glm::vec3 position;   // Location 0
+    glm::vec3 color;      // Location 1
+};
+
+// Concatenates the polylines of many orbits into one vertex buffer and draws
+// all of them with a single glMultiDrawArrays(GL_LINE_LOOP) call. Color is a
+// vertex attribute, so orbits with different colors still share the draw.
+// Each orbit is drawn at the level of detail its projected size needs; the
+// buffer is only rebuilt when some orbit moves to another level.
+class OrbitBatch {
+private:
+    struct Entry {
+        const Orbit* orbit;
+        glm::vec3 color;
+        int level;
+    };
+
+    GLuint VAO = 0, VBO = 0;
+    std::vector<Entry> entries;
+    std::vector<OrbitVertex> vertices;   // All orbits, one after another
+    std::vector<GLint> firsts;           // First vertex of each orbit
+    std::vector<GLsizei> counts;         // Vertex count of each orbit
+    GLsizeiptr capacity = 0;             // Size of VBO in bytes
+    bool dirty = false;                  // Levels changed since the last upload
+
+    // Concatenates every orbit at its current level and uploads the result
+    void rebuild();
+
+public:
+    static const int DEFAULT_LEVEL = 3;  // 128 segments until UpdateLevels runs
+
+    OrbitBatch();
+    ~OrbitBatch();
+
+    OrbitBatch(const OrbitBatch&) = delete;
+    OrbitBatch& operator=(const OrbitBatch&) = delete;
+
+    // Removes every orbit
+    void Clear();
+
+    // Adds the orbit in the given color and returns its index. The orbit is
+    // referenced, not copied, and must outlive the batch or the next Clear.
+    int Add(const Orbit& orbit, const glm::vec3& color);
+
+    int getCount() const { return (int)entries.size(); }
+
+    // Picks each orbit's level for the camera (see Orbit::RequiredLevel)
+    void UpdateLevels(const glm::vec3& cameraPosition, float pixelScale);
+
+    // Vertices drawn per frame at the current levels
+    int getVertexCount() const { return (int)vertices.size(); }
+
+    // Draws every orbit in one call, rebuilding the buffer first if needed.
+    // The orbit shader must be bound.
+    void Draw();
+};
+
+#endif
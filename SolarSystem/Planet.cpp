@@ -1,112 +1,34 @@
 #include "Planet.h"
-#define _USE_MATH_DEFINES
-#include <cmath>
-#include <math.h>
 
-// Constructor: builds sphere geometry and optional orbit
-Planet::Planet(float r, int sectors, int stacks, float orbitRadius)
-    : radius(r), sectorCount(sectors), stackCount(stacks)
+// Constructor: builds optional orbit (the sphere mesh is shared, see getMesh)
+Planet::Planet(float r, float orbitRadius)
+    : radius(r)
 {
-    generateVertices();
-    generateIndices();
-    setupBuffers();
-
     if (orbitRadius > 0.0f) {
-        orbit = new Orbit(orbitRadius);
+        SetOrbit(OrbitalElements::Circular(orbitRadius, 0.0f));
     }
 }
 
-// Destructor: delete buffers and orbit object
-Planet::~Planet() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+void Planet::SetOrbit(const OrbitalElements& orbitElements) {
+    elements = orbitElements;
     delete orbit;
+    orbit = new Orbit(elements);
 }
 
-// Calculate vertex positions and texture coordinates
-void Planet::generateVertices() {
-    float x, y, z, xy;
-    float s, t;
-    float sectorStep = 2.0f * M_PI / sectorCount;
-    float stackStep = M_PI / stackCount;
-    float sectorAngle, stackAngle;
-
-    for (int i = 0; i <= stackCount; ++i) {
-        stackAngle = M_PI / 2 - i * stackStep;
-        xy = 1.02f * radius * cosf(stackAngle);
-        z = radius * sinf(stackAngle);
-
-        for (int j = 0; j <= sectorCount; ++j) {
-            sectorAngle = j * sectorStep;
-            x = xy * cosf(sectorAngle);
-            y = xy * sinf(sectorAngle);
-
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(z);
-
-            s = (float)j / sectorCount;
-            t = (float)i / stackCount;
-            vertices.push_back(s);
-            vertices.push_back(t);
-        }
-    }
+// Destructor: delete orbit object
+Planet::~Planet() {
+    delete orbit;
 }
 
-// Define triangle indices based on sector/stack layout
-void Planet::generateIndices() {
-    int k1, k2;
-    for (int i = 0; i < stackCount; ++i) {
-        k1 = i * (sectorCount + 1);
-        k2 = k1 + sectorCount + 1;
-
-        for (int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
-            if (i != 0) {
-                indices.push_back(k1);
-                indices.push_back(k2);
-                indices.push_back(k1 + 1);
-            }
-            if (i != (stackCount - 1)) {
-                indices.push_back(k1 + 1);
-                indices.push_back(k2);
-                indices.push_back(k2 + 1);
-            }
-        }
-    }
+float Planet::getRadius() const {
+    return radius;
 }
 
-// Upload vertex/index data and configure VAO
-void Planet::setupBuffers() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
+void Planet::UpdateMeshLevel(float screenRadius) {
+    meshLevel = SphereMesh::SelectLevel(screenRadius, meshLevel);
 }
 
-// Render the planet
+// Render the planet (caller scales the unit mesh by getRadius() in the model matrix)
 void Planet::Draw() const {
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, (unsigned int)indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
-
-// Render the orbit if present
-void Planet::DrawOrbit() const {
-    if (orbit) orbit->Draw();
+    getMesh()->Draw();
 }
@@ -3,48 +3,42 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
-#include <vector>
 #include "Orbit.h"
+#include "SphereMesh.h"
 
 class Planet {
 private:
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    GLuint VBO = 0, VAO = 0, EBO = 0;
-
+    int meshLevel = 0;      // Detail of the shared unit icosphere, scaled by radius in the model matrix
     float radius;
-    int sectorCount;
-    int stackCount;
-
-    // Generate sphere vertex data
-    void generateVertices();
-
-    // Generate sphere indices
-    void generateIndices();
-
-    // Set up VAO, VBO, EBO for rendering
-    void setupBuffers();
 
 public:
     float rotationSpeed = 0.0f;
-    float orbitSpeed = 0.0f;
-    GLuint textureID = 0;
+    float mass = 0.0f;    // Gravitational mass for N-body dynamics (G = 1)
+    int textureLayer = 0; // Layer of the body's surface map in the planet texture array
+    int textureStream = -1; // TextureStreamer stream with finer levels of the map, -1 if none
+    int virtualTexture = -1; // VirtualTextureCache map of the surface, -1 if none
 
+    OrbitalElements elements;   // Orbit around the Sun, mirrored by orbit's line geometry
     Orbit* orbit = nullptr;
 
     // Creates planet with optional orbit radius
-    Planet(float r = 1.0f, int sectors = 36, int stacks = 18, float orbitRadius = 0.0f);
+    Planet(float r = 1.0f, float orbitRadius = 0.0f);
 
-    // Clean up OpenGL buffers and orbit
+    // Clean up orbit (the mesh is owned by the SphereMesh cache)
     ~Planet();
 
     float getRadius() const;
 
+    // Replaces the orbit and rebuilds its line geometry from the elements
+    void SetOrbit(const OrbitalElements& elements);
+
+    // Picks the mesh level for the body's projected radius in pixels (with hysteresis)
+    void UpdateMeshLevel(float screenRadius);
+
+    const SphereMesh* getMesh() const { return SphereMesh::Get(meshLevel); }
+
     // Render the sphere
     void Draw() const;
-
-    // Render the orbit if it exists
-    void DrawOrbit() const;
 };
 
 #endif
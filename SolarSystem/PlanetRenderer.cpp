@@ -0,0 +1,115 @@
+#include "PlanetRenderer.h"
+#include <algorithm>
+#include <cstddef>
+
+PlanetRenderer::PlanetRenderer() {
+    glGenBuffers(1, &instanceVBO);
+}
+
+// Delete instance buffer and per-mesh VAOs
+PlanetRenderer::~PlanetRenderer() {
+    for (auto& entry : VAOs)
+        glDeleteVertexArrays(1, &entry.second);
+    glDeleteBuffers(1, &instanceVBO);
+}
+
+// Build a VAO combining the mesh's vertex attributes with the instance buffer
+GLuint PlanetRenderer::getVAO(const SphereMesh* mesh) {
+    auto it = VAOs.find(mesh);
+    if (it != VAOs.end())
+        return it->second;
+
+    GLuint VAO;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    mesh->bindVertexAttributes();
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (int i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(2 + i);
+        glVertexAttribDivisor(2 + i, 1);
+    }
+    glEnableVertexAttribArray(6);
+    glVertexAttribDivisor(6, 1);
+
+    glBindVertexArray(0);
+    VAOs.emplace(mesh, VAO);
+    return VAO;
+}
+
+void PlanetRenderer::Begin() {
+    // Streamed textures come and go, so batches keyed by them do not stay around
+    batches.erase(std::remove_if(batches.begin(), batches.end(),
+        [](const Batch& batch) { return batch.instances.empty(); }), batches.end());
+    for (auto& batch : batches)
+        batch.instances.clear();
+}
+
+// Append instance to the batch using the same mesh and texture
+void PlanetRenderer::Submit(const SphereMesh* mesh, const glm::mat4& model, int textureLayer, GLuint detailTexture) {
+    float layer = (float)textureLayer;
+    for (auto& batch : batches) {
+        if (batch.mesh == mesh && batch.detailTexture == detailTexture) {
+            batch.instances.push_back({ model, layer });
+            return;
+        }
+    }
+    batches.push_back({ mesh, detailTexture, { { model, layer } } });
+}
+
+void PlanetRenderer::Upload() {
+    staging.clear();
+    for (const auto& batch : batches)
+        staging.insert(staging.end(), batch.instances.begin(), batch.instances.end());
+    if (staging.empty())
+        return;
+
+    // Single upload for the whole frame; orphan the buffer when it has to grow
+    GLsizeiptr size = (GLsizeiptr)(staging.size() * sizeof(PlanetInstance));
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (size > instanceCapacity) {
+        instanceCapacity = size;
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity, staging.data(), GL_STREAM_DRAW);
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, staging.data());
+    }
+}
+
+void PlanetRenderer::Draw() {
+    if (staging.empty())
+        return;
+
+    // GL 3.3 has no base instance, so point the instance attributes at each batch's range
+    size_t first = 0;
+    for (const auto& batch : batches) {
+        if (batch.instances.empty())
+            continue;
+
+        glBindVertexArray(getVAO(batch.mesh));
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        size_t base = first * sizeof(PlanetInstance);
+        for (int i = 0; i < 4; ++i) {
+            glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, sizeof(PlanetInstance),
+                (void*)(base + offsetof(PlanetInstance, model) + i * sizeof(glm::vec4)));
+        }
+        glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, sizeof(PlanetInstance),
+            (void*)(base + offsetof(PlanetInstance, textureLayer)));
+
+        if (batch.detailTexture) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, batch.detailTexture);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        glDrawElementsInstanced(GL_TRIANGLES, batch.mesh->getIndexCount(), GL_UNSIGNED_INT, 0,
+            (GLsizei)batch.instances.size());
+        first += batch.instances.size();
+    }
+    glBindVertexArray(0);
+}
+
+void PlanetRenderer::Flush() {
+    Upload();
+    Draw();
+}
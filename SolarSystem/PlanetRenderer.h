@@ -0,0 +1,65 @@
+#ifndef PLANET_RENDERER_H
+#define PLANET_RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <map>
+#include <vector>
+#include "SphereMesh.h"
+
+// Per-instance data streamed to planet.vs (attribute locations 2-6)
+struct PlanetInstance {
+    glm::mat4 model;     // Locations 2-5, one column each
+    float textureLayer;  // Location 6
+};
+
+// Collects planet draws for a frame and submits every body that shares a
+// mesh with a single glDrawElementsInstanced call. Surface maps come from one
+// texture array indexed per instance, so textures never split a batch; only
+// bodies drawn from a streamed texture (TextureStreamer) or a virtual
+// texture's indirection table (VirtualTextureCache) get their own.
+class PlanetRenderer {
+private:
+    struct Batch {
+        const SphereMesh* mesh;
+        GLuint detailTexture;   // Streamed map or indirection table bound to unit 1, 0 for the array
+        std::vector<PlanetInstance> instances;
+    };
+
+    GLuint instanceVBO = 0;
+    GLsizeiptr instanceCapacity = 0;            // Size of instanceVBO in bytes
+    std::map<const SphereMesh*, GLuint> VAOs;   // One instanced VAO per mesh
+    std::vector<Batch> batches;                 // Reused between frames
+    std::vector<PlanetInstance> staging;        // All instances of the frame, batch by batch
+
+    // Returns the instanced VAO for the mesh, creating it on first use
+    GLuint getVAO(const SphereMesh* mesh);
+
+public:
+    PlanetRenderer();
+    ~PlanetRenderer();
+
+    PlanetRenderer(const PlanetRenderer&) = delete;
+    PlanetRenderer& operator=(const PlanetRenderer&) = delete;
+
+    // Clears the instances queued last frame and drops batches it did not use
+    void Begin();
+
+    // Queues one body for drawing. With a detailTexture the body samples that
+    // GL_TEXTURE_2D instead of the array and textureLayer says how: -1 for a
+    // streamed map, VirtualTextureCache::InstanceLayer for an indirection table.
+    void Submit(const SphereMesh* mesh, const glm::mat4& model, int textureLayer, GLuint detailTexture = 0);
+
+    // Uploads all queued instances in one buffer update
+    void Upload();
+
+    // Issues one draw per mesh from the last Upload; a frame drawn in several
+    // passes uploads once and draws once per pass. The pass's shader (and for
+    // planet.fs the surface texture array) must be bound.
+    void Draw();
+
+    // Upload and Draw, for a frame drawn in one pass
+    void Flush();
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "Profiler.h"
+#include "Text.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Weight of the newest sample in the smoothed stage timings
+static const double SMOOTHING = 0.1;
+
+static void smooth(double& value, double sample) {
+    value = value == 0.0 ? sample : value + (sample - value) * SMOOTHING;
+}
+
+Profiler::Profiler() : origin(std::chrono::steady_clock::now()) {}
+
+// Delete every query object, including ones still in flight
+Profiler::~Profiler() {
+    for (auto& slot : pending)
+        for (const PendingQuery& query : slot)
+            glDeleteQueries(1, &query.query);
+    for (const OpenScope& scope : openScopes)
+        if (scope.query) glDeleteQueries(1, &scope.query);
+    if (!freeQueries.empty())
+        glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+}
+
+double Profiler::nowUs() const {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+}
+
+int Profiler::stageIndex(const char* name) {
+    for (size_t i = 0; i < stages.size(); ++i)
+        if (stages[i].name == name || std::strcmp(stages[i].name, name) == 0)
+            return (int)i;
+    StageStats stats;
+    stats.name = name;
+    stages.push_back(stats);
+    return (int)stages.size() - 1;
+}
+
+void Profiler::record(int stage, double startUs, double durationUs, int track) {
+    if (trace.size() < MAX_TRACE_EVENTS)
+        trace.push_back({ stages[stage].name, startUs, durationUs, track });
+}
+
+void Profiler::BeginFrame() {
+    frameSlot = (frameSlot + 1) % FRAME_LATENCY;
+
+    // Queries issued FRAME_LATENCY frames ago are normally done by now
+    for (const PendingQuery& query : pending[frameSlot]) {
+        GLint available = 0;
+        glGetQueryObjectiv(query.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            glDeleteQueries(1, &query.query); // Never stall; drop the sample
+            continue;
+        }
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query.query, GL_QUERY_RESULT, &elapsedNs);
+        StageStats& stats = stages[query.stage];
+        smooth(stats.gpuMs, elapsedNs / 1.0e6);
+        stats.hasGpu = true;
+        record(query.stage, query.startUs, elapsedNs / 1.0e3, 1);
+        freeQueries.push_back(query.query);
+    }
+    pending[frameSlot].clear();
+
+    frameStartUs = nowUs();
+}
+
+void Profiler::EndFrame() {
+    int stage = stageIndex("frame");
+    double durationUs = nowUs() - frameStartUs;
+    smooth(stages[stage].cpuMs, durationUs / 1.0e3);
+    record(stage, frameStartUs, durationUs, 0);
+}
+
+void Profiler::BeginScope(const char* name, bool gpu) {
+    OpenScope scope = { stageIndex(name), nowUs(), 0 };
+    if (gpu && !gpuScopeOpen) {
+        if (freeQueries.empty()) {
+            GLuint query;
+            glGenQueries(1, &query);
+            freeQueries.push_back(query);
+        }
+        scope.query = freeQueries.back();
+        freeQueries.pop_back();
+        glBeginQuery(GL_TIME_ELAPSED, scope.query);
+        gpuScopeOpen = true;
+    }
+    openScopes.push_back(scope);
+}
+
+void Profiler::EndScope() {
+    if (openScopes.empty())
+        return;
+    OpenScope scope = openScopes.back();
+    openScopes.pop_back();
+
+    if (scope.query) {
+        glEndQuery(GL_TIME_ELAPSED);
+        gpuScopeOpen = false;
+        pending[frameSlot].push_back({ scope.stage, scope.startUs, scope.query });
+    }
+
+    double durationUs = nowUs() - scope.startUs;
+    smooth(stages[scope.stage].cpuMs, durationUs / 1.0e3);
+    record(scope.stage, scope.startUs, durationUs, 0);
+}
+
+void Profiler::DrawOverlay(Text& text, float x, float y, float scale) const {
+    const float lineHeight = 40.0f * scale;
+    char line[128];
+    for (const StageStats& stats : stages) {
+        if (stats.hasGpu)
+            std::snprintf(line, sizeof(line), "%-12s cpu %6.3f ms  gpu %6.3f ms", stats.name, stats.cpuMs, stats.gpuMs);
+        else
+            std::snprintf(line, sizeof(line), "%-12s cpu %6.3f ms", stats.name, stats.cpuMs);
+        text.AddText(line, x, y, scale, glm::vec3(0.8f, 1.0f, 0.8f));
+        y -= lineHeight;
+    }
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "ERROR::PROFILER: Could not write " << path << std::endl;
+        return false;
+    }
+
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"GPU\"}}";
+    char event[256];
+    for (const TraceEvent& e : trace) {
+        std::snprintf(event, sizeof(event),
+            ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+            e.name, e.startUs, e.durationUs, e.track);
+        file << event;
+    }
+    file << "\n]}\n";
+    return (bool)file;
+}
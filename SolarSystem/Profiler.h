@@ -0,0 +1,102 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <glad/glad.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+class Text;
+
+// Smoothed timings of one named stage of the frame
+struct StageStats {
+    const char* name;
+    double cpuMs = 0.0;
+    double gpuMs = 0.0;   // Stays 0 for CPU-only scopes
+    bool hasGpu = false;
+};
+
+// Frame profiler with CPU scopes and GL_TIME_ELAPSED queries. GPU results are
+// read FRAME_LATENCY frames later so the CPU never waits on the GPU; queries
+// still pending by then are dropped. Scope names must be string literals.
+class Profiler {
+public:
+    static const int FRAME_LATENCY = 4;
+
+    Profiler();
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Marks the frame boundaries; BeginFrame also collects finished GPU queries
+    void BeginFrame();
+    void EndFrame();
+
+    // Opens a named scope. GL_TIME_ELAPSED queries cannot nest, so a GPU scope
+    // opened inside another GPU scope is timed on the CPU only.
+    void BeginScope(const char* name, bool gpu = true);
+    void EndScope();
+
+    const std::vector<StageStats>& getStages() const { return stages; }
+
+    // Queues one line per stage ("name  cpu ms  gpu ms") on text; caller flushes
+    void DrawOverlay(Text& text, float x, float y, float scale = 0.6f) const;
+
+    // Writes recorded CPU and GPU events in Chrome trace JSON (chrome://tracing, Perfetto).
+    // GPU events are placed at the CPU time their scope was opened.
+    bool WriteChromeTrace(const std::string& path) const;
+
+private:
+    struct OpenScope {
+        int stage;
+        double startUs;
+        GLuint query;  // 0 for CPU-only scopes
+    };
+    struct PendingQuery {
+        int stage;
+        double startUs;
+        GLuint query;
+    };
+    struct TraceEvent {
+        const char* name;
+        double startUs;
+        double durationUs;
+        int track;     // 0 = CPU, 1 = GPU
+    };
+
+    std::vector<StageStats> stages;
+    std::vector<OpenScope> openScopes;
+    std::vector<PendingQuery> pending[FRAME_LATENCY]; // Ring of in-flight queries per frame
+    std::vector<GLuint> freeQueries;
+    std::vector<TraceEvent> trace;
+    int frameSlot = 0;
+    bool gpuScopeOpen = false;
+    double frameStartUs = 0.0;
+    std::chrono::steady_clock::time_point origin;
+
+    static const size_t MAX_TRACE_EVENTS = 200000;
+
+    int stageIndex(const char* name);
+    double nowUs() const;
+    void record(int stage, double startUs, double durationUs, int track);
+};
+
+// RAII scope; a null profiler disables it
+class ProfileScope {
+private:
+    Profiler* profiler;
+
+public:
+    ProfileScope(Profiler* profiler, const char* name, bool gpu = true) : profiler(profiler) {
+        if (profiler) profiler->BeginScope(name, gpu);
+    }
+    ~ProfileScope() {
+        if (profiler) profiler->EndScope();
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#endif
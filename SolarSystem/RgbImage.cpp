@@ -0,0 +1,99 @@
+#include "RgbImage.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cstring>
+
+#include "AssetPack.h"
+
+// Bilinear resample of an RGB image into dst (dstW x dstH x 3)
+static void resizeRGB(const unsigned char* src, int srcW, int srcH,
+    unsigned char* dst, int dstW, int dstH)
+{
+    float sx = (float)srcW / dstW;
+    float sy = (float)srcH / dstH;
+
+    for (int y = 0; y < dstH; ++y) {
+        float fy = std::max(0.0f, (y + 0.5f) * sy - 0.5f);
+        int y0 = std::min((int)fy, srcH - 1);
+        int y1 = std::min(y0 + 1, srcH - 1);
+        float ty = fy - y0;
+
+        for (int x = 0; x < dstW; ++x) {
+            float fx = std::max(0.0f, (x + 0.5f) * sx - 0.5f);
+            int x0 = std::min((int)fx, srcW - 1);
+            int x1 = std::min(x0 + 1, srcW - 1);
+            float tx = fx - x0;
+
+            const unsigned char* p00 = src + (y0 * srcW + x0) * 3;
+            const unsigned char* p10 = src + (y0 * srcW + x1) * 3;
+            const unsigned char* p01 = src + (y1 * srcW + x0) * 3;
+            const unsigned char* p11 = src + (y1 * srcW + x1) * 3;
+            unsigned char* out = dst + (y * dstW + x) * 3;
+
+            for (int c = 0; c < 3; ++c) {
+                float top = p00[c] + (p10[c] - p00[c]) * tx;
+                float bottom = p01[c] + (p11[c] - p01[c]) * tx;
+                out[c] = (unsigned char)(top + (bottom - top) * ty + 0.5f);
+            }
+        }
+    }
+}
+
+// 2x2 box filter into the next mip level; odd edges repeat the last texel
+static void downsampleRGB(const unsigned char* src, int srcW, int srcH,
+    unsigned char* dst, int dstW, int dstH)
+{
+    for (int y = 0; y < dstH; ++y) {
+        int y0 = std::min(y * 2, srcH - 1), y1 = std::min(y * 2 + 1, srcH - 1);
+        for (int x = 0; x < dstW; ++x) {
+            int x0 = std::min(x * 2, srcW - 1), x1 = std::min(x * 2 + 1, srcW - 1);
+            for (int c = 0; c < 3; ++c) {
+                int sum = src[(y0 * srcW + x0) * 3 + c] + src[(y0 * srcW + x1) * 3 + c]
+                        + src[(y1 * srcW + x0) * 3 + c] + src[(y1 * srcW + x1) * 3 + c];
+                dst[(y * dstW + x) * 3 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+bool RgbImage::Load(const std::string& path, int targetWidth, int targetHeight) {
+    int w, h, nrChannels;
+    unsigned char* data;
+    AssetPack::Asset asset;
+    const AssetPack* pack = AssetPack::Mounted();
+    if (pack && pack->Find(path, asset))
+        data = stbi_load_from_memory(asset.data, (int)asset.size, &w, &h, &nrChannels, 3);
+    else
+        data = stbi_load(path.c_str(), &w, &h, &nrChannels, 3);
+    if (!data)
+        return false;
+
+    bool resize = targetWidth > 0 && targetHeight > 0 && (targetWidth != w || targetHeight != h);
+    width = resize ? targetWidth : w;
+    height = resize ? targetHeight : h;
+    pixels.resize((size_t)width * height * 3);
+    levelOffsets.assign(1, 0);
+    if (resize)
+        resizeRGB(data, w, h, pixels.data(), width, height);
+    else
+        std::memcpy(pixels.data(), data, pixels.size());
+    stbi_image_free(data);
+    return true;
+}
+
+void RgbImage::BuildMips() {
+    size_t total = 0;
+    levelOffsets.clear();
+    for (int level = 0; ; ++level) {
+        levelOffsets.push_back(total);
+        total += (size_t)getLevelWidth(level) * getLevelHeight(level) * 3;
+        if (getLevelWidth(level) == 1 && getLevelHeight(level) == 1)
+            break;
+    }
+    pixels.resize(total);
+
+    for (int level = 1; level < getLevelCount(); ++level) {
+        downsampleRGB(&pixels[levelOffsets[level - 1]], getLevelWidth(level - 1), getLevelHeight(level - 1),
+            &pixels[levelOffsets[level]], getLevelWidth(level), getLevelHeight(level));
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef RGB_IMAGE_H
+#define RGB_IMAGE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// RGB8 image with an optional mip chain, levels stored back to back. Shared
+// by the runtime TextureLoader and the offline texture cooker.
+struct RgbImage {
+    int width = 0, height = 0;
+    std::vector<unsigned char> pixels;
+    std::vector<size_t> levelOffsets;   // Byte offset of each level in pixels
+
+    // Decodes an image file (stb_image, from the mounted AssetPack if packed) into level 0, resampled to width x
+    // height when both are positive; false if the file cannot be read
+    bool Load(const std::string& path, int width = 0, int height = 0);
+
+    // Replaces any existing levels with 2x2 box-filtered ones down to 1x1
+    void BuildMips();
+
+    int getLevelCount() const { return (int)levelOffsets.size(); }
+    int getLevelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+    int getLevelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+    const unsigned char* getLevel(int level) const { return &pixels[levelOffsets[level]]; }
+};
+
+#endif
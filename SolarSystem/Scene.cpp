@@ -0,0 +1,416 @@
+#include "Scene.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <utility>
+
+#include "JobSystem.h"
+
+// Constructor: GL state, shaders, bodies, textures and optional text
+Scene::Scene(const std::string& fontPath, int asteroidCount)
+    : planetShader("planet.vs", "planet.fs"),
+      backgroundShader("background.vs", "background.fs"),
+      orbitShader("orbit.vs", "orbit.fs"),
+      asteroidShader("asteroid.vs", "asteroid.fs"),
+      sun(25.0f)
+{
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+
+    planetShader.Use();
+    planetShader.setInt("ourTexture", 0);
+    planetShader.setInt("detailTexture", 1);
+    planetShader.setInt("pageCache", 2);
+
+    // Resolve uniform locations once; the render loop only uses locations
+    orbitModelLoc = orbitShader.getUniformLocation("model");
+
+    asteroidShader.Use();
+    asteroidShader.setFloat("pointScale", 400.0f);
+    asteroidShader.setVec3("asteroidColor", glm::vec3(0.05f, 0.045f, 0.04f));
+
+    // Create Sun and planets
+    // Textures load in the background; placeholders show until they arrive.
+    // The array is BC1 compressed when every surface map has been cooked.
+    std::vector<SurfaceMap> surfaceMaps;
+    setupPlanets(surfaceMaps);
+    textureLoader = new TextureLoader();
+    std::vector<std::string> surfacePaths;
+    for (const SurfaceMap& surfaceMap : surfaceMaps)
+        surfacePaths.push_back(surfaceMap.path);
+    bool compressed = textureLoader->CanLoadCompressed(surfacePaths, 2048, 1024);
+    planetTextures = new TextureArray((int)surfaceMaps.size(), 2048, 1024, compressed);
+    for (int layer = 0; layer < (int)surfaceMaps.size(); ++layer)
+        textureLoader->LoadLayer(*planetTextures, layer, surfaceMaps[layer].path, surfaceMaps[layer].placeholder);
+    starsTexture = textureLoader->Load2D("assets/stars.jpg", glm::vec3(0.0f));
+
+    // Pre-tiled maps are virtually textured: only the pages on screen are resident
+    if (compressed) {
+        for (int index = 0; index < (int)planets.size() + 1; ++index) {
+            Planet& body = getBody(index);
+            std::string tiledPath = TiledTexture::PathFor(surfaceMaps[body.textureLayer].path);
+            TiledTexture tiled;
+            if (!tiled.Open(tiledPath))
+                continue;
+            if (!virtualTextures)
+                virtualTextures = new VirtualTextureCache();
+            body.virtualTexture = virtualTextures->Add(tiledPath);
+        }
+        if (virtualTextures) {
+            planetShader.Use();
+            planetShader.setFloat("pageCachePages", (float)virtualTextures->getCachePages());
+        }
+    }
+
+    // Other cooked maps larger than the array stream their finer levels on demand
+    if (compressed) {
+        textureStreamer = new TextureStreamer();
+        for (int index = 0; index < (int)planets.size() + 1; ++index) {
+            Planet& body = getBody(index);
+            if (body.virtualTexture < 0) {
+                body.textureStream = textureStreamer->Add(CookedTexture::PathFor(surfaceMaps[body.textureLayer].path),
+                    planetTextures->width, planetTextures->height);
+            }
+        }
+        if (textureStreamer->getStreamCount() == 0) {
+            delete textureStreamer;
+            textureStreamer = nullptr;
+        }
+    }
+
+    for (const Planet* planet : planets) {
+        if (planet->orbit)
+            orbitBatch.Add(*planet->orbit, glm::vec3(0.6f));
+    }
+
+    // Main belt between Mars and Jupiter
+    if (asteroidCount > 0) {
+        AsteroidCatalog catalog;
+        catalog.GenerateMainBelt(asteroidCount);
+        asteroids = new AsteroidField(std::move(catalog));
+    }
+
+    // Background quad
+    setupQuad();
+
+    // Initialize text rendering system
+    if (!fontPath.empty())
+        text = new Text(fontPath, 24);
+}
+
+Scene::~Scene() {
+    StopSimulationThread();
+    delete textureLoader;
+    delete textureStreamer;
+    delete virtualTextures;
+    delete asteroids;
+    delete text;
+    delete planetTextures;
+    for (Planet* planet : planets)
+        delete planet;
+
+    glDeleteTextures(1, &starsTexture);
+    glDeleteVertexArrays(1, &quadVAO);
+    glDeleteBuffers(1, &quadVBO);
+    SphereMesh::ReleaseAll();
+}
+
+void Scene::Resize(int newWidth, int newHeight) {
+    if (newWidth <= 0 || newHeight <= 0)
+        return;
+    width = newWidth;
+    height = newHeight;
+
+    glViewport(0, 0, width, height);
+    frameUniforms.SetViewport(width, height);
+    if (text)
+        text->SetProjection(glm::ortho(0.0f, (float)width, 0.0f, (float)height));
+}
+
+void Scene::Update(double frameTime) {
+    if (simulationThread)
+        return;
+    ProfileScope scope(&profiler, "simulation", false);
+    simulation.Advance(frameTime);
+}
+
+void Scene::StartSimulationThread() {
+    if (!simulationThread)
+        simulationThread = new SimulationThread(simulation);
+}
+
+void Scene::StopSimulationThread() {
+    delete simulationThread;
+    simulationThread = nullptr;
+}
+
+void Scene::ModifySimulation(std::function<void(Simulation&)> change) {
+    if (simulationThread)
+        simulationThread->Post(std::move(change));
+    else
+        change(simulation);
+}
+
+void Scene::FinishLoading() {
+    if (!textureLoader)
+        return;
+    textureLoader->Finish();
+    delete textureLoader;
+    textureLoader = nullptr;
+}
+
+void Scene::Render(const Camera& camera) {
+    // One finished texture per frame keeps upload hitches short
+    if (textureLoader) {
+        ProfileScope scope(&profiler, "texture uploads", false);
+        if (!textureLoader->Update()) {
+            delete textureLoader;
+            textureLoader = nullptr;
+        }
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Interpolated body state and the simulation time it corresponds to
+    double renderTime;
+    if (simulationThread) {
+        renderTime = simulationThread->Interpolate(bodyStates);
+    }
+    else {
+        renderTime = simulation.getRenderTime();
+        bodyStates.resize(simulation.getBodyCount());
+        for (int index = 0; index < (int)bodyStates.size(); ++index)
+            bodyStates[index] = simulation.getRenderState(index);
+    }
+
+    // Render background
+    {
+        ProfileScope scope(&profiler, "background");
+        glDisable(GL_DEPTH_TEST);
+        backgroundShader.Use();
+        glBindVertexArray(quadVAO);
+        glBindTexture(GL_TEXTURE_2D, starsTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    // Upload camera state once for every scene shader
+    frameUniforms.SetView(camera.GetViewMatrix(), camera.Position);
+    frameUniforms.Upload();
+
+    // Render planet orbits
+    {
+        ProfileScope scope(&profiler, "orbits");
+        orbitShader.Use();
+        orbitShader.setMat4(orbitModelLoc, glm::mat4(1.0f));
+
+        // Pixels per unit at distance 1, from the projection's focal length
+        const FrameUniformData& frame = frameUniforms.getData();
+        float pixelScale = frame.projection[1][1] * frame.viewport.y * 0.5f;
+        orbitBatch.UpdateLevels(camera.Position, pixelScale);
+        orbitBatch.Draw();
+    }
+
+    // Render Sun and planets with one instanced draw per mesh
+    {
+        ProfileScope scope(&profiler, "planets");
+        planetShader.Use();
+        planetRenderer.Begin();
+
+        // Model matrices from the interpolated simulation state, frustum culling and
+        // mesh level selection run on the job system; only the submission below
+        // touches GL state
+        const FrameUniformData& frame = frameUniforms.getData();
+        const Frustum frustum(frame.projection * frame.view);
+        const float pixelScale = frame.projection[1][1] * frame.viewport.y * 0.5f;
+        int bodyCount = (int)planets.size() + 1;
+        bodyModels.resize(bodyCount);
+        bodyVisible.resize(bodyCount);
+        bodyScreenRadius.resize(bodyCount);
+        JobSystem::Get().ParallelFor(0, bodyCount, 256, [&](int begin, int end) {
+            for (int index = begin; index < end; ++index) {
+                Planet& body = getBody(index);
+                const BodyState& state = bodyStates[index];
+                bodyVisible[index] = frustum.IntersectsSphere(state.position, body.getRadius() * 1.02f);
+                float distance = glm::length(state.position - camera.Position);
+                float screenRadius = body.getRadius() * pixelScale / std::max(distance, body.getRadius());
+                body.UpdateMeshLevel(screenRadius);
+                bodyScreenRadius[index] = bodyVisible[index] ? screenRadius : 0.0f;
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), state.position);
+                model = glm::rotate(model, state.rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+                bodyModels[index] = glm::scale(model, glm::vec3(body.getRadius()));
+            }
+        });
+
+        // Stream surface map levels for the bodies' new screen sizes
+        if (textureStreamer) {
+            ProfileScope streamScope(&profiler, "texture streaming", false);
+            for (int index = 0; index < bodyCount; ++index) {
+                if (getBody(index).textureStream >= 0)
+                    textureStreamer->SetScreenRadius(getBody(index).textureStream, bodyScreenRadius[index]);
+            }
+            textureStreamer->Update();
+        }
+
+        for (int index = 0; index < bodyCount; ++index) {
+            if (!bodyVisible[index])
+                continue;
+            const Planet& body = getBody(index);
+            int layer = body.textureLayer;
+            GLuint detailTexture = 0;
+            if (body.virtualTexture >= 0) {
+                layer = VirtualTextureCache::InstanceLayer(body.virtualTexture);
+                detailTexture = virtualTextures->getIndirection(body.virtualTexture);
+            }
+            else if (body.textureStream >= 0 && (detailTexture = textureStreamer->getTexture(body.textureStream))) {
+                layer = -1;
+            }
+            planetRenderer.Submit(body.getMesh(), bodyModels[index], layer, detailTexture);
+        }
+
+        // Same draws into the small feedback target first; pages it asked for
+        // earlier are uploaded before the frame samples them
+        planetRenderer.Upload();
+        if (virtualTextures) {
+            ProfileScope feedbackScope(&profiler, "texture feedback", false);
+            virtualTextures->RenderFeedback(width, height, [this] { planetRenderer.Draw(); });
+            virtualTextures->Update();
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, virtualTextures->getCacheTexture());
+        }
+        glActiveTexture(GL_TEXTURE0);
+        planetTextures->Bind();
+        planetRenderer.Draw();
+    }
+
+    // Propagate the asteroid belt into its vertex buffer (mapped on the CPU path,
+    // transform feedback on the GPU path) and draw it as points
+    if (asteroids) {
+        {
+            ProfileScope scope(&profiler, "asteroid orbits", asteroids->getGpuPropagation());
+            asteroids->Update(renderTime);
+        }
+        ProfileScope scope(&profiler, "asteroids");
+        asteroidShader.Use();
+
+        // Dim additive points without depth writes: dense regions read as brighter
+        // belt instead of an opaque wall, and planets still occlude them
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        glDepthMask(GL_FALSE);
+        asteroids->Draw();
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+
+    // Render text (HUD and profiler overlay in one batch)
+    if (text) {
+        ProfileScope scope(&profiler, "text");
+        text->AddText("SV 42/2021 Dusica Trbovic", width - 300.0f, 30.0f, 1.0f, glm::vec3(1, 1, 1));
+        if (showProfiler)
+            profiler.DrawOverlay(*text, 10.0f, height - 30.0f);
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        text->Flush();
+        glDisable(GL_BLEND);
+    }
+}
+
+void Scene::setupQuad() {
+    float quadVertices[] = {
+        -1.0f,  1.0f,  0.0f, 1.0f,
+        -1.0f, -1.0f,  0.0f, 0.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+        -1.0f,  1.0f,  0.0f, 1.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+         1.0f,  1.0f,  1.0f, 1.0f
+    };
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glBindVertexArray(0);
+}
+
+void Scene::setupPlanets(std::vector<SurfaceMap>& surfaceMaps) {
+    // Registers a surface map and returns its texture array layer
+    auto addSurfaceMap = [&surfaceMaps](const char* path, const glm::vec3& placeholder) {
+        surfaceMaps.push_back({ path, placeholder });
+        return (int)surfaceMaps.size() - 1;
+    };
+
+    // Semi-major axis, mean motion (rad/s), then eccentricity, inclination, ascending
+    // node and argument of periapsis (degrees) from the real planets; all start at periapsis
+    auto planetOrbit = [](float a, float n, float e, float inclination, float node, float periapsis) {
+        OrbitalElements orbit = OrbitalElements::Circular(a, n);
+        orbit.eccentricity = e;
+        orbit.inclination = glm::radians(inclination);
+        orbit.ascendingNode = glm::radians(node);
+        orbit.periapsis = glm::radians(periapsis);
+        return orbit;
+    };
+
+    // Sun mass chosen so a circular orbit at Earth's radius (85) has Earth's
+    // orbit speed (1 rad/s); planet masses keep their real ratios to the Sun
+    const float sunMass = 85.0f * 85.0f * 85.0f;
+    sun.rotationSpeed = 0.2f;
+    sun.mass = sunMass;
+    sun.textureLayer = addSurfaceMap("assets/sun.jpg", glm::vec3(1.0f, 0.6f, 0.15f));
+
+    Planet* mercury = new Planet(2.0f);
+    mercury->rotationSpeed = 0.02f;
+    mercury->SetOrbit(planetOrbit(40.0f, 4.17f, 0.2056f, 7.0f, 48.33f, 29.12f));
+    mercury->mass = sunMass * 1.66e-7f;
+    mercury->textureLayer = addSurfaceMap("assets/mercury.jpg", glm::vec3(0.55f, 0.53f, 0.5f));
+
+    Planet* venus = new Planet(3.0f);
+    venus->rotationSpeed = -0.00f;
+    venus->SetOrbit(planetOrbit(60.0f, 1.61f, 0.0068f, 3.39f, 76.68f, 54.88f));
+    venus->mass = sunMass * 2.45e-6f;
+    venus->textureLayer = addSurfaceMap("assets/venus.jpg", glm::vec3(0.85f, 0.75f, 0.55f));
+
+    Planet* earth = new Planet(3.0f);
+    earth->rotationSpeed = 1.0f;
+    earth->SetOrbit(planetOrbit(85.0f, 1.0f, 0.0167f, 0.0f, 0.0f, 114.21f));
+    earth->mass = sunMass * 3.00e-6f;
+    earth->textureLayer = addSurfaceMap("assets/earth.jpg", glm::vec3(0.2f, 0.35f, 0.6f));
+
+    Planet* mars = new Planet(2.5f);
+    mars->rotationSpeed = 0.97f;
+    mars->SetOrbit(planetOrbit(110.0f, 0.53f, 0.0934f, 1.85f, 49.56f, 286.5f));
+    mars->mass = sunMass * 3.23e-7f;
+    mars->textureLayer = addSurfaceMap("assets/mars.jpg", glm::vec3(0.7f, 0.35f, 0.2f));
+
+    Planet* jupiter = new Planet(7.0f);
+    jupiter->rotationSpeed = 2.4f;
+    jupiter->SetOrbit(planetOrbit(150.0f, 0.084f, 0.0489f, 1.3f, 100.46f, 273.87f));
+    jupiter->mass = sunMass * 9.55e-4f;
+    jupiter->textureLayer = addSurfaceMap("assets/jupiter.jpg", glm::vec3(0.8f, 0.7f, 0.55f));
+
+    Planet* saturn = new Planet(6.0f);
+    saturn->rotationSpeed = 2.27f;
+    saturn->SetOrbit(planetOrbit(230.0f, 0.034f, 0.0565f, 2.49f, 113.67f, 339.39f));
+    saturn->mass = sunMass * 2.86e-4f;
+    saturn->textureLayer = addSurfaceMap("assets/saturn.jpg", glm::vec3(0.85f, 0.78f, 0.6f));
+
+    Planet* uranus = new Planet(4.0f);
+    uranus->rotationSpeed = -1.39f;
+    uranus->SetOrbit(planetOrbit(300.0f, 0.012f, 0.0463f, 0.77f, 74.01f, 96.99f));
+    uranus->mass = sunMass * 4.37e-5f;
+    uranus->textureLayer = addSurfaceMap("assets/uranus.jpg", glm::vec3(0.6f, 0.8f, 0.85f));
+
+    planets = { mercury, venus, earth, mars, jupiter, saturn, uranus };
+
+    // Register bodies with the simulation in the same order
+    simulation.AddBody(sun.elements, sun.rotationSpeed, sun.mass);
+    for (Planet* planet : planets)
+        simulation.AddBody(planet->elements, planet->rotationSpeed, planet->mass);
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "AsteroidField.h"
+#include "Camera.h"
+#include "FrameUniforms.h"
+#include "Frustum.h"
+#include "OrbitBatch.h"
+#include "Planet.h"
+#include "PlanetRenderer.h"
+#include "Profiler.h"
+#include "Shader.h"
+#include "Simulation.h"
+#include "SimulationThread.h"
+#include "Text.h"
+#include "TextureArray.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
+#include "VirtualTextureCache.h"
+
+// Owns every GL resource of the solar system and draws complete frames.
+// Shared by the windowed app and the headless renderer so both go through
+// the same Shader/Planet/Orbit code paths. Requires a current GL 3.3 context.
+class Scene {
+public:
+    // Loads shaders, textures and bodies; text is skipped when fontPath is empty.
+    // asteroidCount synthetic main-belt asteroids are drawn as points (0 for none).
+    Scene(const std::string& fontPath, int asteroidCount = 0);
+
+    // Deletes bodies and GL objects (call while the context is still current)
+    ~Scene();
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    // Updates viewport, projection and text projection for a new framebuffer size
+    void Resize(int width, int height);
+
+    // Advances the simulation by real frame time (fixed ticks, see Simulation).
+    // Does nothing while the simulation thread runs, it keeps its own time.
+    void Update(double frameTime);
+
+    // Moves the simulation to its own thread; Render then draws its snapshots
+    void StartSimulationThread();
+
+    // Joins the simulation thread and returns to stepping in Update()
+    void StopSimulationThread();
+
+    // Runs change on the simulation, directly or queued on its thread
+    void ModifySimulation(std::function<void(Simulation&)> change);
+
+    // Blocks until every texture has been decoded and uploaded; otherwise they
+    // stream in during the first frames and placeholders are drawn meanwhile
+    void FinishLoading();
+
+    // Draws one frame into the bound framebuffer using the interpolated body state.
+    // Each stage is timed by the profiler; frame boundaries are up to the caller.
+    void Render(const Camera& camera);
+
+    Profiler& getProfiler() { return profiler; }
+    // Asteroid belt, nullptr when the scene was created without one
+    AsteroidField* getAsteroids() { return asteroids; }
+    // Mip streaming of large surface maps, nullptr when none exceeds the texture array
+    TextureStreamer* getTextureStreamer() { return textureStreamer; }
+    // Virtual texturing of pre-tiled surface maps, nullptr when none is tiled
+    VirtualTextureCache* getVirtualTextures() { return virtualTextures; }
+    // Direct access; only safe while the simulation thread is not running
+    Simulation& getSimulation() { return simulation; }
+
+    // Shows per-stage CPU/GPU timings in the text overlay
+    bool showProfiler = false;
+
+private:
+    // Surface map image and the color shown while it loads
+    struct SurfaceMap {
+        std::string path;
+        glm::vec3 placeholder;
+    };
+
+    Shader planetShader;
+    Shader backgroundShader;
+    Shader orbitShader;
+    Shader asteroidShader;
+    GLint orbitModelLoc;
+
+    FrameUniforms frameUniforms;
+    PlanetRenderer planetRenderer;
+    OrbitBatch orbitBatch;   // Every planet orbit, drawn in one call
+
+    Planet sun;
+    std::vector<Planet*> planets;
+    Simulation simulation; // Body 0 is the sun, body i + 1 is planets[i]
+    SimulationThread* simulationThread = nullptr;
+    std::vector<BodyState> bodyStates;   // Interpolated state drawn this frame
+    std::vector<glm::mat4> bodyModels;   // Per-frame model matrices, filled by jobs
+    std::vector<char> bodyVisible;       // Frustum test result per body
+    std::vector<float> bodyScreenRadius; // Projected radius in pixels, 0 when culled
+    TextureArray* planetTextures = nullptr;
+    TextureLoader* textureLoader = nullptr;   // Until every texture is uploaded
+    TextureStreamer* textureStreamer = nullptr;
+    VirtualTextureCache* virtualTextures = nullptr;
+    AsteroidField* asteroids = nullptr;
+
+    unsigned int starsTexture = 0;
+    unsigned int quadVAO = 0, quadVBO = 0;
+
+    Text* text = nullptr;
+    Profiler profiler;
+    int width = 1, height = 1;
+
+    // Initializes the sun and creates all planet objects with movement properties;
+    // appends each body's surface map to surfaceMaps and stores its layer index
+    void setupPlanets(std::vector<SurfaceMap>& surfaceMaps);
+
+    // Sets up a fullscreen quad for rendering the background texture
+    void setupQuad();
+
+    const Planet& getBody(int index) const { return index == 0 ? sun : *planets[index - 1]; }
+    Planet& getBody(int index) { return index == 0 ? sun : *planets[index - 1]; }
+};
+
+#endif
@@ -1,30 +1,32 @@
 #include "Shader.h"
+#include "AssetPack.h"
+#include "FrameUniforms.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 // Constructor: loads shader source, compiles and links shaders
 Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath) {
-    std::string vertexCode = loadShaderCode(vertexPath);
-    std::string fragmentCode = loadShaderCode(fragmentPath);
-    std::string geometryCode;
+    Source vertexCode = loadShaderCode(vertexPath);
+    Source fragmentCode = loadShaderCode(fragmentPath);
+    Source geometryCode;
 
     if (geometryPath)
         geometryCode = loadShaderCode(geometryPath);
 
-    GLuint vertex = compileShader(GL_VERTEX_SHADER, vertexCode.c_str());
-    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, fragmentCode.c_str());
+    GLuint vertex = compileShader(GL_VERTEX_SHADER, vertexCode);
+    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, fragmentCode);
     GLuint geometry;
     if (geometryPath)
-        geometry = compileShader(GL_GEOMETRY_SHADER, geometryCode.c_str());
+        geometry = compileShader(GL_GEOMETRY_SHADER, geometryCode);
 
     ID = glCreateProgram();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
     if (geometryPath)
         glAttachShader(ID, geometry);
-    glLinkProgram(ID);
-    checkCompileErrors(ID, "PROGRAM");
+    linkProgram();
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
@@ -32,13 +34,52 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geo
         glDeleteShader(geometry);
 }
 
+// Constructor for a vertex-only program whose outputs are captured with
+// transform feedback, interleaved in the order given
+Shader::Shader(const char* vertexPath, const std::vector<std::string>& feedbackVaryings) {
+    Source vertexCode = loadShaderCode(vertexPath);
+    GLuint vertex = compileShader(GL_VERTEX_SHADER, vertexCode);
+
+    std::vector<const GLchar*> names;
+    for (const std::string& varying : feedbackVaryings)
+        names.push_back(varying.c_str());
+
+    ID = glCreateProgram();
+    glAttachShader(ID, vertex);
+    glTransformFeedbackVaryings(ID, (GLsizei)names.size(), names.data(), GL_INTERLEAVED_ATTRIBS);
+    linkProgram();
+
+    glDeleteShader(vertex);
+}
+
+// Link the attached stages and set up everything that depends on the linked program
+void Shader::linkProgram() {
+    glLinkProgram(ID);
+    checkCompileErrors(ID, "PROGRAM");
+    cacheUniformLocations();
+
+    // Programs reading per-frame camera data share one uniform buffer
+    GLuint frameBlock = glGetUniformBlockIndex(ID, "FrameUniforms");
+    if (frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID, frameBlock, FrameUniforms::BINDING);
+}
+
 // Activate the shader
 void Shader::Use() const {
     glUseProgram(ID);
 }
 
-// Read shader source code from file
-std::string Shader::loadShaderCode(const char* path) {
+// Point at the source in the mounted asset pack, or read it from file
+Shader::Source Shader::loadShaderCode(const char* path) {
+    Source source;
+    AssetPack::Asset asset;
+    const AssetPack* pack = AssetPack::Mounted();
+    if (pack && pack->Find(path, asset)) {
+        source.packed = (const char*)asset.data;
+        source.length = (GLint)asset.size;
+        return source;
+    }
+
     std::ifstream file;
     std::stringstream buffer;
     file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
@@ -50,13 +91,16 @@ std::string Shader::loadShaderCode(const char* path) {
     catch (std::ifstream::failure&) {
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
     }
-    return buffer.str();
+    source.loose = buffer.str();
+    return source;
 }
 
-// Compile a shader of given type
-GLuint Shader::compileShader(GLenum type, const char* code) {
+// Compile a shader of given type; packed sources are not zero-terminated
+GLuint Shader::compileShader(GLenum type, const Source& source) {
+    const GLchar* code = source.packed ? source.packed : source.loose.c_str();
+    GLint length = source.packed ? source.length : (GLint)source.loose.size();
     GLuint shader = glCreateShader(type);
-    glShaderSource(shader, 1, &code, nullptr);
+    glShaderSource(shader, 1, &code, &length);
     glCompileShader(shader);
     std::string typeStr = (type == GL_VERTEX_SHADER) ? "VERTEX" :
         (type == GL_FRAGMENT_SHADER) ? "FRAGMENT" : "GEOMETRY";
@@ -86,40 +130,170 @@ void Shader::checkCompileErrors(GLuint shader, const std::string& type) {
     }
 }
 
+// FNV-1a hash of a zero-terminated string
+static uint32_t hashUniformName(const char* name, size_t& length) {
+    uint32_t hash = 2166136261u;
+    const char* c = name;
+    for (; *c; ++c) {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+    length = (size_t)(c - name);
+    return hash;
+}
+
+// Introspect active uniforms once and store their locations
+void Shader::cacheUniformLocations() {
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    // Arrays get one entry per element plus the bare name, so reserve generously
+    size_t capacity = 16;
+    while (capacity < (size_t)count * 4)
+        capacity *= 2;
+    uniformTable.assign(capacity, UniformSlot());
+    uniformCount = 0;
+
+    std::vector<GLchar> nameBuffer(std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        GLint location = glGetUniformLocation(ID, name.c_str());
+        if (location < 0)
+            continue; // Uniform block member, set through its buffer
+
+        // Array uniforms are reported as "name[0]": register "name" and each element
+        size_t bracket = name.find('[');
+        if (bracket == std::string::npos) {
+            insertUniform(name, location);
+            continue;
+        }
+        std::string base = name.substr(0, bracket);
+        insertUniform(base, location);
+        for (GLint element = 0; element < size; ++element) {
+            std::string elementName = base + "[" + std::to_string(element) + "]";
+            GLint elementLocation = glGetUniformLocation(ID, elementName.c_str());
+            if (elementLocation >= 0)
+                insertUniform(elementName, elementLocation);
+        }
+    }
+}
+
+void Shader::insertUniform(const std::string& name, GLint location) {
+    // Grow when more than half full to keep probe sequences short
+    if ((uniformCount + 1) * 2 > uniformTable.size()) {
+        std::vector<UniformSlot> old;
+        old.swap(uniformTable);
+        uniformTable.assign(old.size() * 2, UniformSlot());
+        uniformCount = 0;
+        for (const auto& slot : old)
+            if (!slot.name.empty()) insertUniform(slot.name, slot.location);
+    }
+
+    size_t length;
+    uint32_t hash = hashUniformName(name.c_str(), length);
+    size_t mask = uniformTable.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        UniformSlot& slot = uniformTable[i];
+        if (slot.name.empty() || slot.name == name) {
+            if (slot.name.empty())
+                ++uniformCount;
+            slot.hash = hash;
+            slot.location = location;
+            slot.name = name;
+            return;
+        }
+    }
+}
+
+GLint Shader::getUniformLocation(const char* name) const {
+    if (uniformTable.empty())
+        return -1;
+
+    size_t length;
+    uint32_t hash = hashUniformName(name, length);
+    size_t mask = uniformTable.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        const UniformSlot& slot = uniformTable[i];
+        if (slot.name.empty())
+            return -1;
+        if (slot.hash == hash && slot.name.size() == length && slot.name.compare(0, length, name) == 0)
+            return slot.location;
+    }
+}
+
+GLint Shader::getUniformLocation(const std::string& name) const {
+    return getUniformLocation(name.c_str());
+}
+
 // Uniform functions
 void Shader::setBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    setBool(getUniformLocation(name), value);
 }
 void Shader::setInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(getUniformLocation(name), value);
 }
 void Shader::setFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    setFloat(getUniformLocation(name), value);
 }
 void Shader::setVec2(const std::string& name, const glm::vec2& value) const {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec2(getUniformLocation(name), value);
 }
 void Shader::setVec2(const std::string& name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    glUniform2f(getUniformLocation(name), x, y);
 }
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec3(getUniformLocation(name), value);
 }
 void Shader::setVec3(const std::string& name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(getUniformLocation(name), x, y, z);
 }
 void Shader::setVec4(const std::string& name, const glm::vec4& value) const {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec4(getUniformLocation(name), value);
 }
 void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+    glUniform4f(getUniformLocation(name), x, y, z, w);
 }
 void Shader::setMat2(const std::string& name, const glm::mat2& mat) const {
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat2(getUniformLocation(name), mat);
 }
 void Shader::setMat3(const std::string& name, const glm::mat3& mat) const {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat3(getUniformLocation(name), mat);
 }
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat4(getUniformLocation(name), mat);
+}
+
+// Location based uniform functions
+void Shader::setBool(GLint location, bool value) const {
+    glUniform1i(location, (int)value);
+}
+void Shader::setInt(GLint location, int value) const {
+    glUniform1i(location, value);
+}
+void Shader::setFloat(GLint location, float value) const {
+    glUniform1f(location, value);
+}
+void Shader::setVec2(GLint location, const glm::vec2& value) const {
+    glUniform2fv(location, 1, &value[0]);
+}
+void Shader::setVec3(GLint location, const glm::vec3& value) const {
+    glUniform3fv(location, 1, &value[0]);
+}
+void Shader::setVec4(GLint location, const glm::vec4& value) const {
+    glUniform4fv(location, 1, &value[0]);
+}
+void Shader::setMat2(GLint location, const glm::mat2& mat) const {
+    glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+void Shader::setMat3(GLint location, const glm::mat3& mat) const {
+    glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+void Shader::setMat4(GLint location, const glm::mat4& mat) const {
+    glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
 }
@@ -3,7 +3,9 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 class Shader {
 public:
@@ -12,10 +14,19 @@ public:
     // Constructor: loads and builds the shader program
     Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr);
 
+    // Vertex-only program for transform feedback; the listed outputs are
+    // captured interleaved into the buffer bound to feedback binding 0
+    Shader(const char* vertexPath, const std::vector<std::string>& feedbackVaryings);
+
     // Activate the shader
     void Use() const;
 
-    // Utility uniform functions
+    // Resolve a uniform name to its location through the link-time cache
+    // (-1 if the uniform is not active). Resolve once, then use the location setters.
+    GLint getUniformLocation(const std::string& name) const;
+    GLint getUniformLocation(const char* name) const;
+
+    // Utility uniform functions (name lookups go through the cache, never the driver)
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
     void setFloat(const std::string& name, float value) const;
@@ -29,13 +40,47 @@ public:
     void setMat3(const std::string& name, const glm::mat3& mat) const;
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
+    // Location based setters for hot loops
+    void setBool(GLint location, bool value) const;
+    void setInt(GLint location, int value) const;
+    void setFloat(GLint location, float value) const;
+    void setVec2(GLint location, const glm::vec2& value) const;
+    void setVec3(GLint location, const glm::vec3& value) const;
+    void setVec4(GLint location, const glm::vec4& value) const;
+    void setMat2(GLint location, const glm::mat2& mat) const;
+    void setMat3(GLint location, const glm::mat3& mat) const;
+    void setMat4(GLint location, const glm::mat4& mat) const;
+
 private:
+    // Open-addressing hash table of active uniforms, filled once after linking
+    struct UniformSlot {
+        uint32_t hash = 0;
+        GLint location = -1;
+        std::string name; // Empty for unused slots
+    };
+    std::vector<UniformSlot> uniformTable; // Size is a power of two
+    size_t uniformCount = 0;                // Occupied slots in uniformTable
+
+    // Query active uniforms (GL_ACTIVE_UNIFORMS) and fill uniformTable
+    void cacheUniformLocations();
+    void insertUniform(const std::string& name, GLint location);
+
+    // Link, check, cache uniforms and bind the FrameUniforms block
+    void linkProgram();
+
     // Utility to check shader compilation/linking errors
     void checkCompileErrors(GLuint shader, const std::string& type);
 
+    // Stage source: a view into the mounted AssetPack, or a loose file's text
+    struct Source {
+        const char* packed = nullptr;
+        GLint length = 0;
+        std::string loose;
+    };
+
     // Helpers
-    std::string loadShaderCode(const char* path);
-    GLuint compileShader(GLenum type, const char* code);
+    Source loadShaderCode(const char* path);
+    GLuint compileShader(GLenum type, const Source& source);
 };
 
 #endif
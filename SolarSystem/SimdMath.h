@@ -0,0 +1,150 @@
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+
+#include <cmath>
+
+// Thin wrappers over the widest float vector the target has (AVX2: 8 lanes,
+// AArch64 NEON: 4, otherwise a plain float), so kernels such as the Kepler
+// solver are written once. Masks come from comparisons and feed Select().
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace simd {
+
+#if defined(__AVX2__)
+
+typedef __m256 Float;
+typedef __m256 Mask;
+static const int WIDTH = 8;
+
+inline Float Set(float v) { return _mm256_set1_ps(v); }
+inline Float Load(const float* p) { return _mm256_loadu_ps(p); }
+inline void Store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+inline Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+inline Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+inline Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+inline Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+inline Float Floor(Float a) { return _mm256_floor_ps(a); }
+inline Mask Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline Float Select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+
+// a * b + c
+inline Float MulAdd(Float a, Float b, Float c) {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+// m0 + n * t wrapped to [-pi, pi), evaluated in double precision so large t
+// keeps its phase; two 4-lane double halves per vector
+inline Float MeanAnomaly(const float* m0, const float* n, double t) {
+    const __m256d time = _mm256_set1_pd(t);
+    const __m256d twoPi = _mm256_set1_pd(6.283185307179586);
+    const __m256d inverseTwoPi = _mm256_set1_pd(0.15915494309189535);
+    const __m256d half = _mm256_set1_pd(0.5);
+    __m128 result[2];
+    for (int h = 0; h < 2; ++h) {
+        __m256d m = _mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(m0 + 4 * h)),
+                                  _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(n + 4 * h)), time));
+        __m256d turns = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(m, inverseTwoPi), half));
+        result[h] = _mm256_cvtpd_ps(_mm256_sub_pd(m, _mm256_mul_pd(turns, twoPi)));
+    }
+    return _mm256_set_m128(result[1], result[0]);
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+typedef float32x4_t Float;
+typedef uint32x4_t Mask;
+static const int WIDTH = 4;
+
+inline Float Set(float v) { return vdupq_n_f32(v); }
+inline Float Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, Float v) { vst1q_f32(p, v); }
+inline Float Add(Float a, Float b) { return vaddq_f32(a, b); }
+inline Float Sub(Float a, Float b) { return vsubq_f32(a, b); }
+inline Float Mul(Float a, Float b) { return vmulq_f32(a, b); }
+inline Float Div(Float a, Float b) { return vdivq_f32(a, b); }
+inline Float Floor(Float a) { return vrndmq_f32(a); }
+inline Mask Less(Float a, Float b) { return vcltq_f32(a, b); }
+inline Float Select(Mask m, Float a, Float b) { return vbslq_f32(m, a, b); }
+inline Float MulAdd(Float a, Float b, Float c) { return vfmaq_f32(c, a, b); }
+
+// m0 + n * t wrapped to [-pi, pi), evaluated in double precision
+inline Float MeanAnomaly(const float* m0, const float* n, double t) {
+    const float64x2_t time = vdupq_n_f64(t);
+    const float64x2_t twoPi = vdupq_n_f64(6.283185307179586);
+    const float64x2_t inverseTwoPi = vdupq_n_f64(0.15915494309189535);
+    const float64x2_t half = vdupq_n_f64(0.5);
+    float32x4_t m0f = vld1q_f32(m0), nf = vld1q_f32(n);
+    float64x2_t low = vfmaq_f64(vcvt_f64_f32(vget_low_f32(m0f)), vcvt_f64_f32(vget_low_f32(nf)), time);
+    float64x2_t high = vfmaq_f64(vcvt_high_f64_f32(m0f), vcvt_high_f64_f32(nf), time);
+    low = vfmsq_f64(low, vrndmq_f64(vfmaq_f64(half, low, inverseTwoPi)), twoPi);
+    high = vfmsq_f64(high, vrndmq_f64(vfmaq_f64(half, high, inverseTwoPi)), twoPi);
+    return vcombine_f32(vcvt_f32_f64(low), vcvt_f32_f64(high));
+}
+
+#else
+
+typedef float Float;
+typedef bool Mask;
+static const int WIDTH = 1;
+
+inline Float Set(float v) { return v; }
+inline Float Load(const float* p) { return *p; }
+inline void Store(float* p, Float v) { *p = v; }
+inline Float Add(Float a, Float b) { return a + b; }
+inline Float Sub(Float a, Float b) { return a - b; }
+inline Float Mul(Float a, Float b) { return a * b; }
+inline Float Div(Float a, Float b) { return a / b; }
+inline Float Floor(Float a) { return std::floor(a); }
+inline Mask Less(Float a, Float b) { return a < b; }
+inline Float Select(Mask m, Float a, Float b) { return m ? a : b; }
+inline Float MulAdd(Float a, Float b, Float c) { return a * b + c; }
+
+// m0 + n * t wrapped to [-pi, pi), evaluated in double precision
+inline Float MeanAnomaly(const float* m0, const float* n, double t) {
+    double m = *m0 + *n * t;
+    return (float)(m - 6.283185307179586 * std::floor(m * 0.15915494309189535 + 0.5));
+}
+
+#endif
+
+// Sine and cosine together. Reduces x by the nearest multiple of pi/2 in three
+// parts (Cody-Waite), evaluates the Cephes minimax polynomials on [-pi/4, pi/4]
+// and fixes up the quadrant with selects. Error ~1e-7 for |x| up to ~1e4.
+inline void SinCos(Float x, Float& s, Float& c) {
+    const Float quadrant = Floor(MulAdd(x, Set(0.636619772f), Set(0.5f)));
+    Float r = MulAdd(quadrant, Set(-1.5703125f), x);
+    r = MulAdd(quadrant, Set(-4.837512969970703125e-4f), r);
+    r = MulAdd(quadrant, Set(-7.54978995489188216e-8f), r);
+
+    const Float z = Mul(r, r);
+    Float sinPoly = MulAdd(Set(-1.9515295891e-4f), z, Set(8.3321608736e-3f));
+    sinPoly = MulAdd(sinPoly, z, Set(-1.6666654611e-1f));
+    sinPoly = MulAdd(Mul(sinPoly, z), r, r);
+    Float cosPoly = MulAdd(Set(2.443315711809948e-5f), z, Set(-1.388731625493765e-3f));
+    cosPoly = MulAdd(cosPoly, z, Set(4.166664568298827e-2f));
+    cosPoly = MulAdd(Mul(cosPoly, z), z, MulAdd(Set(-0.5f), z, Set(1.0f)));
+
+    // Quadrant modulo 4: odd quadrants swap sin and cos, 2-3 negate sin, 1-2 negate cos
+    const Float q = Sub(quadrant, Mul(Set(4.0f), Floor(Mul(quadrant, Set(0.25f)))));
+    const Float half = Mul(q, Set(0.5f));
+    const Mask odd = Less(Set(0.25f), Sub(half, Floor(half)));
+    Float sinValue = Select(odd, cosPoly, sinPoly);
+    Float cosValue = Select(odd, sinPoly, cosPoly);
+
+    Float qc = Add(q, Set(1.0f));
+    qc = Sub(qc, Mul(Set(4.0f), Floor(Mul(qc, Set(0.25f)))));
+    s = Select(Less(Set(1.5f), q), Sub(Set(0.0f), sinValue), sinValue);
+    c = Select(Less(Set(1.5f), qc), Sub(Set(0.0f), cosValue), cosValue);
+}
+
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include "Simulation.h"
+#include <algorithm>
+#include <cmath>
+
+#include "JobSystem.h"
+
+Simulation::Simulation(double timestep) : timestep(timestep) {}
+
+int Simulation::AddBody(float orbitRadius, float orbitSpeed, float rotationSpeed, float mass) {
+    return AddBody(OrbitalElements::Circular(orbitRadius, orbitSpeed), rotationSpeed, mass);
+}
+
+int Simulation::AddBody(const OrbitalElements& orbit, float rotationSpeed, float mass) {
+    BodyParams body = { orbit, rotationSpeed, mass };
+    params.push_back(body);
+    kepler.Add(orbit);
+    BodyState state = evaluate(body, time);
+    previous.push_back(state);
+    current.push_back(state);
+    if (dynamics == Dynamics::Gravity)
+        SetDynamics(Dynamics::Gravity);
+    return (int)params.size() - 1;
+}
+
+void Simulation::SetDynamics(Dynamics dynamics) {
+    this->dynamics = dynamics;
+    if (dynamics == Dynamics::Analytic) {
+        for (size_t i = 0; i < params.size(); ++i)
+            current[i] = evaluate(params[i], time);
+        previous = current;
+        return;
+    }
+
+    // Vis-viva speed around the primary, v^2 = G (M + m) (2 / r - 1 / a), along the
+    // direction of travel on each body's orbit, so orbits keep their shape
+    nbody.Clear();
+    glm::vec3 primary = params.empty() ? glm::vec3(0.0f) : current[0].position;
+    float primaryMass = params.empty() ? 0.0f : params[0].mass;
+    for (size_t i = 0; i < params.size(); ++i) {
+        const OrbitalElements& orbit = params[i].orbit;
+        glm::vec3 offset = current[i].position - primary;
+        float r = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+        glm::vec3 velocity(0.0f);
+        if (i > 0 && r > 0.0f && orbit.semiMajorAxis > 0.0f) {
+            float energy = std::max(2.0f / r - 1.0f / orbit.semiMajorAxis, 0.0f);
+            float speed = std::sqrt(nbody.G * (primaryMass + params[i].mass) * energy);
+            velocity = orbit.DirectionAt(time) * speed;
+        }
+        nbody.AddBody(current[i].position, velocity, params[i].mass);
+    }
+    nbody.RemoveNetMomentum();
+    previous = current;
+}
+
+void Simulation::Advance(double frameTime) {
+    if (paused)
+        return;
+
+    accumulator += std::min(frameTime, maxFrameTime);
+    while (accumulator >= timestep) {
+        step();
+        accumulator -= timestep;
+    }
+}
+
+void Simulation::Run(double duration) {
+    accumulator += duration;
+    while (accumulator >= timestep) {
+        step();
+        accumulator -= timestep;
+    }
+}
+
+void Simulation::step() {
+    previous.swap(current);
+    time += timestep;
+    if (dynamics == Dynamics::Gravity) {
+        nbody.Step((float)timestep);
+        JobSystem::Get().ParallelFor(0, (int)params.size(), 1024, [this](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                current[i].position = nbody.getPosition(i);
+                current[i].rotation = previous[i].rotation + (float)(timestep * params[i].rotationSpeed);
+            }
+        });
+        return;
+    }
+    if (params.empty())
+        return;
+
+    // Positions as arrays, then into the state array
+    keplerX.resize(params.size());
+    keplerY.resize(params.size());
+    keplerZ.resize(params.size());
+    kepler.Propagate(time, keplerX.data(), keplerY.data(), keplerZ.data());
+    for (size_t i = 0; i < params.size(); ++i) {
+        current[i].position = glm::vec3(keplerX[i], keplerY[i], keplerZ[i]);
+        current[i].rotation = rotationAt(params[i], time);
+    }
+}
+
+float Simulation::rotationAt(const BodyParams& body, double t) const {
+    return (float)(body.orbit.meanAnomaly + t * (body.orbit.meanMotion + body.rotationSpeed));
+}
+
+BodyState Simulation::evaluate(const BodyParams& body, double t) const {
+    BodyState state;
+    state.position = body.orbit.PositionAt(t);
+    state.rotation = rotationAt(body, t);
+    return state;
+}
+
+BodyState Simulation::getRenderState(int body) const {
+    float alpha = getAlpha();
+    const BodyState& a = previous[body];
+    const BodyState& b = current[body];
+    BodyState state;
+    state.position = a.position + (b.position - a.position) * alpha;
+    state.rotation = a.rotation + (b.rotation - a.rotation) * alpha;
+    return state;
+}
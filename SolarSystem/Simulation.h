@@ -0,0 +1,106 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Kepler.h"
+#include "NBody.h"
+
+// State of one body after a simulation tick
+struct BodyState {
+    glm::vec3 position;   // World position of the body's center
+    float rotation;       // Orientation around the Y axis in radians
+};
+
+// Advances the bodies with a fixed timestep, independent of the frame rate.
+// Frame time is accumulated and consumed in whole ticks; rendering interpolates
+// between the last two ticks with getAlpha(), so any refresh rate looks smooth.
+// Bodies either follow their Keplerian orbits in closed form or, with gravity enabled,
+// are integrated as a mutually attracting N-body system.
+class Simulation {
+public:
+    enum class Dynamics {
+        Analytic,   // Kepler orbits evaluated in closed form (KeplerBatch)
+        Gravity     // Direct-sum N-body integration (NBodySystem)
+    };
+
+    // Movement parameters of one body (orbit around the origin)
+    struct BodyParams {
+        OrbitalElements orbit;
+        float rotationSpeed;  // Spin in radians per second
+        float mass;           // Gravitational mass (G = 1), used by Dynamics::Gravity
+    };
+
+    explicit Simulation(double timestep = 1.0 / 120.0);
+
+    // Adds a body and returns its index
+    int AddBody(const OrbitalElements& orbit, float rotationSpeed, float mass = 0.0f);
+
+    // Adds a body on a circular orbit in the XZ plane (orbitSpeed in radians per second)
+    int AddBody(float orbitRadius, float orbitSpeed, float rotationSpeed, float mass = 0.0f);
+
+    // Switching to Gravity seeds the N-body system from the current positions with
+    // vis-viva velocities around body 0 along each orbit; switching back resumes
+    // the analytic orbits
+    void SetDynamics(Dynamics dynamics);
+    Dynamics getDynamics() const { return dynamics; }
+
+    // Force backend and its settings persist across SetDynamics calls
+    NBodySystem& getNBody() { return nbody; }
+    const NBodySystem& getNBody() const { return nbody; }
+
+    // Consumes real frame time in fixed ticks. Frame time is clamped to
+    // maxFrameTime so a long stall does not trigger a burst of catch-up ticks.
+    void Advance(double frameTime);
+
+    // Steps exactly through duration regardless of maxFrameTime (offline rendering)
+    void Run(double duration);
+
+    // While paused Advance() is ignored and the interpolated state stays put
+    void SetPaused(bool paused) { this->paused = paused; }
+    bool isPaused() const { return paused; }
+
+    double getTime() const { return time; }
+    double getTimestep() const { return timestep; }
+    float getAlpha() const { return (float)(accumulator / timestep); }
+
+    // Time matching getRenderState(): between the previous and current tick
+    double getRenderTime() const { return time - timestep + accumulator; }
+    int getBodyCount() const { return (int)params.size(); }
+
+    // State blended between the previous and current tick
+    BodyState getRenderState(int body) const;
+
+    // Unblended state at the latest tick and at the one before it
+    const BodyState& getCurrentState(int body) const { return current[body]; }
+    const BodyState& getPreviousState(int body) const { return previous[body]; }
+
+    double maxFrameTime = 0.25;
+
+private:
+    std::vector<BodyParams> params;
+    std::vector<BodyState> previous;
+    std::vector<BodyState> current;
+
+    double timestep;
+    double accumulator = 0.0;
+    double time = 0.0;       // Simulation time of the current state
+    bool paused = false;
+
+    Dynamics dynamics = Dynamics::Analytic;
+    KeplerBatch kepler;      // Body i mirrors params[i].orbit
+    std::vector<float> keplerX, keplerY, keplerZ;   // Positions it propagates into
+    NBodySystem nbody;       // Body i mirrors params[i] while dynamics is Gravity
+
+    // Advance every body by one tick
+    void step();
+
+    // Spin angle at time t; kept coupled to the mean anomaly like the original
+    // rotate(orbit) * translate * rotate(spin) transform
+    float rotationAt(const BodyParams& body, double t) const;
+
+    // Evaluate body state at simulation time t (single body, scalar path)
+    BodyState evaluate(const BodyParams& body, double t) const;
+};
+
+#endif
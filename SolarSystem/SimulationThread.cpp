@@ -0,0 +1,82 @@
+#include "SimulationThread.h"
+#include <algorithm>
+#include <chrono>
+
+SimulationThread::SimulationThread(Simulation& simulation) : simulation(simulation) {
+    publish(Now());
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+SimulationThread::~SimulationThread() {
+    running = false;
+    thread.join();
+}
+
+double SimulationThread::Now() {
+    using Clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::Post(std::function<void(Simulation&)> command) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    commands.push_back(std::move(command));
+}
+
+void SimulationThread::publish(double now) {
+    SimulationSnapshot& snapshot = snapshots.Back();
+    int count = simulation.getBodyCount();
+    snapshot.previous.resize(count);
+    snapshot.current.resize(count);
+    for (int i = 0; i < count; ++i) {
+        snapshot.previous[i] = simulation.getPreviousState(i);
+        snapshot.current[i] = simulation.getCurrentState(i);
+    }
+    snapshot.time = simulation.getTime();
+    snapshot.timestep = simulation.getTimestep();
+    // The accumulator holds time past the latest tick
+    snapshot.tickWallTime = now - simulation.getAlpha() * simulation.getTimestep();
+    snapshots.Publish();
+}
+
+void SimulationThread::run() {
+    double last = Now();
+    while (running) {
+        {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            executing.swap(commands);
+        }
+        bool changed = !executing.empty();
+        for (auto& command : executing)
+            command(simulation);
+        executing.clear();
+
+        double now = Now();
+        double before = simulation.getTime();
+        simulation.Advance(now - last);
+        last = now;
+        if (changed || simulation.getTime() != before)
+            publish(now);
+
+        // Sleep until the next tick is due
+        double remaining = (1.0 - simulation.getAlpha()) * simulation.getTimestep();
+        std::this_thread::sleep_for(std::chrono::duration<double>(std::max(remaining, 0.0005)));
+    }
+}
+
+double SimulationThread::Interpolate(std::vector<BodyState>& states) {
+    snapshots.Update();
+    const SimulationSnapshot& snapshot = snapshots.Front();
+
+    float alpha = 1.0f;
+    if (snapshot.timestep > 0.0)
+        alpha = (float)std::min(std::max((Now() - snapshot.tickWallTime) / snapshot.timestep, 0.0), 1.0);
+
+    states.resize(snapshot.current.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        const BodyState& a = snapshot.previous[i];
+        const BodyState& b = snapshot.current[i];
+        states[i].position = a.position + (b.position - a.position) * alpha;
+        states[i].rotation = a.rotation + (b.rotation - a.rotation) * alpha;
+    }
+    return snapshot.time - (1.0 - alpha) * snapshot.timestep;
+}
@@ -0,0 +1,64 @@
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Simulation.h"
+#include "TripleBuffer.h"
+
+// Last two ticks of a simulation, copied out for the render thread
+struct SimulationSnapshot {
+    std::vector<BodyState> previous;
+    std::vector<BodyState> current;
+    double time = 0.0;          // Simulation time of current
+    double tickWallTime = 0.0;  // Wall clock (seconds) at which current was due
+    double timestep = 0.0;
+};
+
+// Runs a Simulation on its own thread at its fixed tick rate, so a slow step
+// never delays presentation. Every batch of ticks is published as an immutable
+// snapshot through a lock-free triple buffer; the render thread blends the
+// newest snapshot's two ticks by wall clock (one tick of latency). While the
+// thread runs it owns the Simulation: changes go through Post().
+class SimulationThread {
+public:
+    // Publishes the initial state and starts ticking
+    explicit SimulationThread(Simulation& simulation);
+
+    // Stops and joins the thread; the Simulation is safe to use afterwards
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Queues a change that runs on the simulation thread before its next tick
+    void Post(std::function<void(Simulation&)> command);
+
+    // Render thread: body states interpolated from the newest snapshot; returns
+    // the simulation time they correspond to
+    double Interpolate(std::vector<BodyState>& states);
+
+    // Seconds on the clock used for tickWallTime
+    static double Now();
+
+private:
+    Simulation& simulation;
+    TripleBuffer<SimulationSnapshot> snapshots;
+    std::thread thread;
+    std::atomic<bool> running{ true };
+
+    std::mutex commandMutex;
+    std::vector<std::function<void(Simulation&)>> commands;
+    std::vector<std::function<void(Simulation&)>> executing;   // Swapped out under the lock
+
+    // Copies the simulation's last two ticks into the back slot and publishes it
+    void publish(double now);
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include "SphereMesh.h"
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <math.h>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.h"
+
+// One entry per level, filled by the first Get()
+static SphereMesh* meshLevels[SphereMesh::LEVELS] = {};
+
+// CPU-side geometry of one level: position + texcoord per vertex
+struct SphereGeometry {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+};
+
+// Icosahedron with vertices on the poles (z = +-1) and two rings of five
+static void buildIcosahedron(std::vector<float>& positions, std::vector<unsigned int>& triangles) {
+    const float ringZ = 1.0f / std::sqrt(5.0f);
+    const float ringRadius = 2.0f / std::sqrt(5.0f);
+
+    positions = { 0.0f, 0.0f, 1.0f };
+    for (int ring = 0; ring < 2; ++ring) {
+        for (int k = 0; k < 5; ++k) {
+            float angle = (2.0f * k + ring) * (float)M_PI / 5.0f;
+            positions.push_back(ringRadius * cosf(angle));
+            positions.push_back(ringRadius * sinf(angle));
+            positions.push_back(ring == 0 ? ringZ : -ringZ);
+        }
+    }
+    positions.insert(positions.end(), { 0.0f, 0.0f, -1.0f });
+
+    // Counter-clockwise seen from outside
+    triangles.clear();
+    for (int k = 0; k < 5; ++k) {
+        unsigned int upper = 1 + k, upperNext = 1 + (k + 1) % 5;
+        unsigned int lower = 6 + k, lowerNext = 6 + (k + 1) % 5;
+        triangles.insert(triangles.end(), { 0, upper, upperNext });
+        triangles.insert(triangles.end(), { upper, lower, upperNext });
+        triangles.insert(triangles.end(), { upperNext, lower, lowerNext });
+        triangles.insert(triangles.end(), { 11, lowerNext, lower });
+    }
+}
+
+// Splits every triangle into four, pushing the new midpoints onto the unit sphere
+static void subdivide(std::vector<float>& positions, std::vector<unsigned int>& triangles) {
+    std::unordered_map<unsigned long long, unsigned int> midpoints;
+    auto midpoint = [&](unsigned int a, unsigned int b) {
+        unsigned long long key = a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+        auto it = midpoints.find(key);
+        if (it != midpoints.end())
+            return it->second;
+
+        float x = positions[a * 3] + positions[b * 3];
+        float y = positions[a * 3 + 1] + positions[b * 3 + 1];
+        float z = positions[a * 3 + 2] + positions[b * 3 + 2];
+        float length = std::sqrt(x * x + y * y + z * z);
+        unsigned int index = (unsigned int)(positions.size() / 3);
+        positions.insert(positions.end(), { x / length, y / length, z / length });
+        midpoints.emplace(key, index);
+        return index;
+    };
+
+    std::vector<unsigned int> result;
+    result.reserve(triangles.size() * 4);
+    for (size_t t = 0; t < triangles.size(); t += 3) {
+        unsigned int a = triangles[t], b = triangles[t + 1], c = triangles[t + 2];
+        unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+        result.insert(result.end(), { a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca });
+    }
+    triangles.swap(result);
+}
+
+// Builds a level with the UV sphere's texture mapping (poles on z, u around z
+// from +x, v from the north pole). Triangles crossing the u = 0/1 seam get
+// copies of their low-u vertices shifted by one, and each triangle touching a
+// pole gets its own pole vertex at the triangle's mean u, so no triangle
+// interpolates across the whole texture.
+static void buildLevel(int level, SphereGeometry& geometry) {
+    std::vector<float> positions;
+    std::vector<unsigned int> triangles;
+    buildIcosahedron(positions, triangles);
+    for (int i = 0; i < level; ++i)
+        subdivide(positions, triangles);
+
+    size_t positionCount = positions.size() / 3;
+    std::vector<float> u(positionCount), v(positionCount);
+    for (size_t i = 0; i < positionCount; ++i) {
+        float angle = atan2f(positions[i * 3 + 1], positions[i * 3]);
+        u[i] = angle < 0.0f ? angle / (2.0f * (float)M_PI) + 1.0f : angle / (2.0f * (float)M_PI);
+        v[i] = acosf(std::max(-1.0f, std::min(1.0f, positions[i * 3 + 2]))) / (float)M_PI;
+    }
+
+    // Output vertex per (position, shifted) pair; pole vertices are never shared
+    std::vector<int> remap(positionCount * 2, -1);
+    auto emit = [&](unsigned int position, float texU) {
+        // Same slight widening around the pole axis as the original UV sphere
+        const float* p = &positions[position * 3];
+        geometry.vertices.insert(geometry.vertices.end(), { 1.02f * p[0], 1.02f * p[1], p[2], texU, v[position] });
+        return (unsigned int)(geometry.vertices.size() / 5 - 1);
+    };
+
+    geometry.vertices.reserve(positionCount * 5 * 11 / 10);
+    geometry.indices.reserve(triangles.size());
+    for (size_t t = 0; t < triangles.size(); t += 3) {
+        const unsigned int* corner = &triangles[t];
+        bool pole[3];
+        float cornerU[3];
+        float minU = 1.0f, maxU = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            pole[k] = std::fabs(positions[corner[k] * 3 + 2]) > 0.99999f;
+            cornerU[k] = u[corner[k]];
+            if (!pole[k]) {
+                minU = std::min(minU, cornerU[k]);
+                maxU = std::max(maxU, cornerU[k]);
+            }
+        }
+
+        bool seam = maxU - minU > 0.5f;
+        float sumU = 0.0f;
+        int nonPole = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (pole[k])
+                continue;
+            if (seam && cornerU[k] < 0.5f)
+                cornerU[k] += 1.0f;
+            sumU += cornerU[k];
+            ++nonPole;
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            if (pole[k]) {
+                geometry.indices.push_back(emit(corner[k], sumU / nonPole));
+                continue;
+            }
+            int shifted = cornerU[k] >= 1.0f ? 1 : 0;
+            int& index = remap[corner[k] * 2 + shifted];
+            if (index < 0)
+                index = (int)emit(corner[k], cornerU[k]);
+            geometry.indices.push_back((unsigned int)index);
+        }
+    }
+}
+
+const SphereMesh* SphereMesh::Get(int level) {
+    level = std::max(0, std::min(level, LEVELS - 1));
+    if (meshLevels[level])
+        return meshLevels[level];
+
+    // Levels are independent, so they are generated in parallel (the finest
+    // dominates); only the uploads below need the GL thread
+    SphereGeometry geometry[LEVELS];
+    JobSystem::Get().ParallelFor(0, LEVELS, 1, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            buildLevel(i, geometry[i]);
+    });
+    for (int i = 0; i < LEVELS; ++i) {
+        meshLevels[i] = new SphereMesh(i, geometry[i].vertices.data(), geometry[i].vertices.size(),
+            geometry[i].indices.data(), geometry[i].indices.size());
+    }
+    return meshLevels[level];
+}
+
+void SphereMesh::ReleaseAll() {
+    for (SphereMesh*& mesh : meshLevels) {
+        delete mesh;
+        mesh = nullptr;
+    }
+}
+
+// Level l has edges spanning about 1.107 / 2^l radians. A chord of angle a sits
+// r a^2 / 8 inside the sphere, which must stay under half a pixel, so
+// a = 2 / sqrt(r) and the exact level is log2(1.107 sqrt(r) / 2).
+int SphereMesh::SelectLevel(float screenRadius, int currentLevel) {
+    const float hysteresis = 0.25f;   // In levels; 2^0.5 in screen radius
+    float exact = std::log2(0.5535f * std::sqrt(std::max(screenRadius, 1.0f)));
+
+    int finer = (int)std::ceil(exact);
+    if (finer > currentLevel)
+        return std::min(finer, LEVELS - 1);
+    int coarser = (int)std::ceil(exact + hysteresis);
+    return std::max(0, std::min(currentLevel, coarser));
+}
+
+// Upload one level
+SphereMesh::SphereMesh(int level, const float* vertices, size_t vertexFloats,
+    const unsigned int* indices, size_t indexCount)
+    : indexCount((GLsizei)indexCount), level(level)
+{
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexFloats * sizeof(float), vertices, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+
+    bindVertexAttributes();
+
+    glBindVertexArray(0);
+}
+
+// Attach mesh buffers and per-vertex attributes to the bound VAO
+void SphereMesh::bindVertexAttributes() const {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+}
+
+// Delete GPU buffers
+SphereMesh::~SphereMesh() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+}
+
+// Render the sphere
+void SphereMesh::Draw() const {
+    glBindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,52 @@
+#ifndef SPHERE_MESH_H
+#define SPHERE_MESH_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// Unit icosphere at LEVELS subdivision levels, uploaded to the GPU once and
+// shared by every body. Level l has 20 * 4^l triangles of nearly equal size,
+// so detail is spent evenly instead of crowding at the poles like a UV sphere.
+// Bodies scale it to their radius through the model matrix and pick a level
+// from their projected size (SelectLevel).
+class SphereMesh {
+private:
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    GLsizei indexCount = 0;
+    int level;
+
+    // Uploads one level built by buildLevel; CPU-side data is discarded afterwards
+    SphereMesh(int level, const float* vertices, size_t vertexFloats,
+        const unsigned int* indices, size_t indexCount);
+    ~SphereMesh();
+
+public:
+    static const int LEVELS = 6;   // 20 to 20480 triangles
+
+    SphereMesh(const SphereMesh&) = delete;
+    SphereMesh& operator=(const SphereMesh&) = delete;
+
+    // Returns the mesh for a level; the first call builds every level
+    static const SphereMesh* Get(int level);
+
+    // Deletes all cached meshes (call before the GL context is destroyed)
+    static void ReleaseAll();
+
+    // Level whose silhouette stays within half a pixel of a sphere covering
+    // screenRadius pixels. Coarsening waits until the size dropped about 30%
+    // below the switch point, so bodies near a threshold do not flicker.
+    static int SelectLevel(float screenRadius, int currentLevel);
+
+    // Render the sphere
+    void Draw() const;
+
+    // Binds the vertex/index buffers and sets up attributes 0 (position) and 1 (texcoord)
+    // on the currently bound VAO, so other VAOs (e.g. instanced ones) can reuse the mesh
+    void bindVertexAttributes() const;
+
+    GLuint getVAO() const { return VAO; }
+    GLsizei getIndexCount() const { return indexCount; }
+    int getLevel() const { return level; }
+};
+
+#endif
@@ -1,8 +1,13 @@
 #include "Text.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <iostream>
 
-// Constructor: load font, create characters, set up OpenGL buffers
+static const int FLOATS_PER_VERTEX = 7;
+static const int ATLAS_WIDTH = 512;
+static const int GLYPH_PADDING = 1;  // Empty texels between glyphs to avoid bleeding
+
+// Constructor: load font, pack every glyph into one atlas, set up OpenGL buffers
 Text::Text(const std::string& fontPath, int fontSize)
     : shader("text.vs", "text.fs")
 {
@@ -17,61 +22,98 @@ Text::Text(const std::string& fontPath, int fontSize)
     FT_Face face;
     if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
         std::cerr << "ERROR::FREETYPE: Failed to load font\n";
+        FT_Done_FreeType(ft);
         return;
     }
 
     // Set font size
     FT_Set_Pixel_Sizes(face, 0, fontSize);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
 
-    // Load first 96 printable ASCII characters
+    // Shelf-pack the first 96 printable ASCII characters into a CPU-side atlas
+    std::vector<unsigned char> atlas;
+    int penX = GLYPH_PADDING, penY = GLYPH_PADDING, rowHeight = 0;
     for (unsigned char c = 32; c < 128; c++) {
         // Load character glyph
         if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
             std::cerr << "ERROR::FREETYPE: Failed to load Glyph\n";
             continue;
         }
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        int w = (int)bitmap.width;
+        int h = (int)bitmap.rows;
+
+        // Start a new row when the glyph does not fit
+        if (penX + w + GLYPH_PADDING > ATLAS_WIDTH) {
+            penX = GLYPH_PADDING;
+            penY += rowHeight + GLYPH_PADDING;
+            rowHeight = 0;
+        }
+        if ((size_t)(penY + h + GLYPH_PADDING) * ATLAS_WIDTH > atlas.size())
+            atlas.resize((size_t)(penY + h + GLYPH_PADDING) * ATLAS_WIDTH, 0);
 
-        // Generate texture for glyph
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED,
-            face->glyph->bitmap.width, face->glyph->bitmap.rows,
-            0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
-
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // Store character data
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            (unsigned int)face->glyph->advance.x
-        };
+        for (int row = 0; row < h; ++row) {
+            std::copy(bitmap.buffer + row * bitmap.pitch, bitmap.buffer + row * bitmap.pitch + w,
+                atlas.begin() + (size_t)(penY + row) * ATLAS_WIDTH + penX);
+        }
 
-        Characters.insert(std::pair<char, Character>(c, character));
+        // Store character data; UVs are normalized once the atlas height is known
+        Character& character = Characters[c];
+        character.UVMin = glm::vec2((float)penX, (float)penY);
+        character.UVMax = glm::vec2((float)(penX + w), (float)(penY + h));
+        character.Size = glm::ivec2(w, h);
+        character.Bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+        character.Advance = (unsigned int)face->glyph->advance.x;
+
+        penX += w + GLYPH_PADDING;
+        rowHeight = std::max(rowHeight, h);
     }
 
     // Clean up FreeType
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
 
-    // Set up VAO/VBO for rendering characters as quads
+    // Round atlas height up to a power of two and normalize glyph UVs
+    int atlasHeight = 1;
+    while ((size_t)atlasHeight * ATLAS_WIDTH < atlas.size())
+        atlasHeight *= 2;
+    atlas.resize((size_t)atlasHeight * ATLAS_WIDTH, 0);
+    glm::vec2 texelSize(1.0f / ATLAS_WIDTH, 1.0f / atlasHeight);
+    for (Character& character : Characters) {
+        character.UVMin *= texelSize;
+        character.UVMax *= texelSize;
+    }
+
+    // Upload atlas as a single texture
+    GLint previousAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, ATLAS_WIDTH, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, atlas.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+
+    // Set texture options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Set up VAO/VBO for streaming quads: vec4 (pos, tex) + vec3 color
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glBindVertexArray(VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), 0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float), (void*)(4 * sizeof(float)));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
+
+    shader.Use();
+    shader.setInt("text", 0);
 }
 
 // Sets the orthographic projection matrix in the shader
@@ -80,16 +122,15 @@ void Text::SetProjection(const glm::mat4& projection) {
     shader.setMat4("projection", projection);
 }
 
-// Renders a string of text at the specified screen position
-void Text::RenderText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
-    shader.Use();
-    shader.setVec3("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO);
+// Appends two triangles per character to the vertex queue
+void Text::AddText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
+    vertices.reserve(vertices.size() + text.size() * 6 * FLOATS_PER_VERTEX);
 
-    // Iterate over each character in the string
     for (char c : text) {
-        Character ch = Characters[c];
+        unsigned char code = (unsigned char)c;
+        if (code >= GLYPH_COUNT)
+            continue;
+        const Character& ch = Characters[code];
 
         float xpos = x + ch.Bearing.x * scale;
         float ypos = y + (ch.Bearing.y - ch.Size.y) * scale;
@@ -97,30 +138,62 @@ void Text::RenderText(const std::string& text, float x, float y, float scale, gl
         float w = ch.Size.x * scale;
         float h = ch.Size.y * scale;
 
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
+        // Advance cursor for next glyph
+        x += (ch.Advance >> 6) * scale;
+        if (ch.Size.x == 0 || ch.Size.y == 0)
+            continue; // Whitespace has nothing to draw
+
+        const float quad[6][4] = {
+            { xpos,     ypos + h,   ch.UVMin.x, ch.UVMin.y },
+            { xpos,     ypos,       ch.UVMin.x, ch.UVMax.y },
+            { xpos + w, ypos,       ch.UVMax.x, ch.UVMax.y },
 
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }
+            { xpos,     ypos + h,   ch.UVMin.x, ch.UVMin.y },
+            { xpos + w, ypos,       ch.UVMax.x, ch.UVMax.y },
+            { xpos + w, ypos + h,   ch.UVMax.x, ch.UVMin.y }
         };
+        for (const auto& vertex : quad) {
+            vertices.insert(vertices.end(), vertex, vertex + 4);
+            vertices.push_back(color.r);
+            vertices.push_back(color.g);
+            vertices.push_back(color.b);
+        }
+    }
+}
 
-        // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-
-        // Update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+// Submits all queued text with one buffer update and one draw call
+void Text::Flush() {
+    if (vertices.empty() || VAO == 0) {
+        vertices.clear();
+        return;
+    }
 
-        // Render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    shader.Use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glBindVertexArray(VAO);
 
-        // Advance cursor for next glyph
-        x += (ch.Advance >> 6) * scale;
+    // Orphan the previous contents so the driver never waits on last frame's draw
+    size_t size = vertices.size() * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (size > bufferCapacity) {
+        bufferCapacity = size;
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity, vertices.data(), GL_STREAM_DRAW);
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices.data());
     }
 
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(vertices.size() / FLOATS_PER_VERTEX));
+    vertices.clear();
+
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
+
+// Renders a string of text at the specified screen position
+void Text::RenderText(const std::string& text, float x, float y, float scale, glm::vec3 color) {
+    AddText(text, x, y, scale, color);
+    Flush();
+}
@@ -1,17 +1,18 @@
 #ifndef TEXT_RENDERER_H
 #define TEXT_RENDERER_H
 
-#include <map>
 #include <string>
+#include <vector>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Shader.h"
 
-// Stores glyph texture and its metrics
+// Stores glyph location in the atlas and its metrics
 struct Character {
-    unsigned int TextureID;  // ID of glyph texture
+    glm::vec2 UVMin;         // Top-left corner of glyph in the atlas (0..1)
+    glm::vec2 UVMax;         // Bottom-right corner of glyph in the atlas (0..1)
     glm::ivec2 Size;         // Size of glyph
     glm::ivec2 Bearing;      // Offset from baseline to left/top of glyph
     unsigned int Advance;    // Horizontal offset to advance to next glyph
@@ -19,18 +20,31 @@ struct Character {
 
 class Text {
 public:
-    std::map<char, Character> Characters; // Loaded characters
-    unsigned int VAO, VBO;                // Buffers for rendering
-    Shader shader;                        // Shader used for text rendering
+    static const int GLYPH_COUNT = 128;     // Table covers ASCII; only 32..127 are loaded
 
-    // Initializes text rendering with given font
+    Character Characters[GLYPH_COUNT] = {}; // Loaded characters, indexed by ASCII code
+    unsigned int atlasTexture = 0;          // Single texture holding every glyph
+    unsigned int VAO = 0, VBO = 0;          // Streaming buffer for all queued quads
+    Shader shader;                          // Shader used for text rendering
+
+    // Initializes text rendering with given font and builds the glyph atlas
     Text(const std::string& fontPath, int fontSize);
 
-    // Draws text string on screen
+    // Queues a text string; nothing is drawn until Flush()
+    void AddText(const std::string& text, float x, float y, float scale, glm::vec3 color);
+
+    // Uploads every queued quad in one buffer update and draws them with one call
+    void Flush();
+
+    // Draws text string on screen immediately (AddText + Flush)
     void RenderText(const std::string& text, float x, float y, float scale, glm::vec3 color);
 
     // Sets the projection matrix for the text shader
     void SetProjection(const glm::mat4& projection);
+
+private:
+    std::vector<float> vertices;  // Queued vertices: pos.xy, uv.xy, color.rgb
+    size_t bufferCapacity = 0;    // Size of VBO in bytes
 };
 
-#endif
\ No newline at end of file
+#endif
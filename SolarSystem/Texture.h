@@ -0,0 +1,7 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+// Loads a texture from file using stb_image (GL_TEXTURE_2D with mipmaps)
+unsigned int loadTexture(const char* path);
+
+#endif
@@ -0,0 +1,83 @@
+#include "TextureArray.h"
+#include <algorithm>
+#include <vector>
+
+#include "Bc1.h"
+
+// Constructor: allocate storage for every level, sampled with trilinear filtering
+TextureArray::TextureArray(int layers, int width, int height, bool compressed)
+    : width(width), height(height), layers(layers), levels(1), compressed(compressed)
+{
+    while ((std::max(width, height) >> levels) > 0)
+        ++levels;
+
+    glGenTextures(1, &ID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+    for (int level = 0; level < levels; ++level) {
+        int w = std::max(1, width >> level), h = std::max(1, height >> level);
+        if (compressed) {
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, w, h, layers, 0,
+                (GLsizei)(bc1::CompressedSize(w, h) * layers), NULL);
+        }
+        else {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGB8, w, h, layers, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+TextureArray::~TextureArray() {
+    glDeleteTextures(1, &ID);
+}
+
+// Clear each level of the layer through a temporary framebuffer; GL 3.3 has no
+// glClearTexImage. The caller's framebuffer and clear color are restored.
+// Compressed formats cannot be rendered to, so those upload solid blocks.
+void TextureArray::FillLayer(int layer, const glm::vec3& color) {
+    if (compressed) {
+        unsigned char block[8];
+        bc1::SolidBlock((unsigned char)(color.r * 255.0f + 0.5f), (unsigned char)(color.g * 255.0f + 0.5f),
+            (unsigned char)(color.b * 255.0f + 0.5f), block);
+        std::vector<unsigned char> blocks(bc1::CompressedSize(width, height));
+        for (size_t offset = 0; offset < blocks.size(); offset += 8)
+            std::copy(block, block + 8, &blocks[offset]);
+
+        GLint previousUnpackBuffer;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previousUnpackBuffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        Bind();
+        for (int level = 0; level < levels; ++level) {
+            int w = std::max(1, width >> level), h = std::max(1, height >> level);
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, w, h, 1,
+                GL_COMPRESSED_RGB_S3TC_DXT1_EXT, (GLsizei)bc1::CompressedSize(w, h), blocks.data());
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (GLuint)previousUnpackBuffer);
+        return;
+    }
+
+    GLint previousFramebuffer;
+    GLfloat previousClearColor[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor);
+
+    GLuint FBO;
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+    glClearColor(color.r, color.g, color.b, 1.0f);
+    for (int level = 0; level < levels; ++level) {
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, ID, level, layer);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousFramebuffer);
+    glDeleteFramebuffers(1, &FBO);
+    glClearColor(previousClearColor[0], previousClearColor[1], previousClearColor[2], previousClearColor[3]);
+}
+
+void TextureArray::Bind() const {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+}
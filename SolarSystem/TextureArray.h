@@ -0,0 +1,41 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// EXT_texture_compression_s3tc, not part of the GL 3.3 core glad header
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+// One GL_TEXTURE_2D_ARRAY holding the surface maps of many bodies, so bodies
+// with different maps can be drawn in the same batch. Every layer has the same
+// resolution and a full mip chain; images are filled in by TextureLoader.
+// A compressed array stores BC1 blocks and takes cooked textures only.
+class TextureArray {
+public:
+    GLuint ID = 0;
+    int width;
+    int height;
+    int layers;
+    int levels;        // Mip levels down to 1x1
+    bool compressed;   // GL_COMPRESSED_RGB_S3TC_DXT1_EXT instead of GL_RGB8
+
+    // Allocates every layer and mip level (contents undefined until filled)
+    TextureArray(int layers, int width = 2048, int height = 1024, bool compressed = false);
+
+    ~TextureArray();
+
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+
+    // Sets every mip level of a layer to a solid color, used as a placeholder
+    // until the layer's image arrives
+    void FillLayer(int layer, const glm::vec3& color);
+
+    // Bind to GL_TEXTURE_2D_ARRAY on the active texture unit
+    void Bind() const;
+};
+
+#endif
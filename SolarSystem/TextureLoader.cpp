@@ -0,0 +1,235 @@
+#include "TextureLoader.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+TextureLoader::TextureLoader(int threadCount) {
+    if (threadCount <= 0)
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount && !s3tc; ++i)
+        s3tc = !std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_EXT_texture_compression_s3tc");
+
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(&TextureLoader::threadLoop, this);
+    glGenBuffers(1, &PBO);
+}
+
+TextureLoader::~TextureLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        requests.clear();
+    }
+    queued.notify_all();
+    for (std::thread& thread : threads)
+        thread.join();
+    glDeleteBuffers(1, &PBO);
+}
+
+void TextureLoader::queue(const Request& request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back(request);
+    }
+    ++outstanding;
+    queued.notify_one();
+}
+
+bool TextureLoader::CanLoadCompressed(const std::vector<std::string>& paths, int width, int height) const {
+    if (!s3tc)
+        return false;
+    for (const std::string& path : paths) {
+        int cookedWidth, cookedHeight;
+        if (!CookedTexture::ReadHeader(CookedTexture::PathFor(path), cookedWidth, cookedHeight)
+            || CookedTexture::FindLevel(cookedWidth, cookedHeight, width, height) < 0)
+            return false;
+    }
+    return true;
+}
+
+void TextureLoader::LoadLayer(TextureArray& array, int layer, const std::string& path, const glm::vec3& placeholder) {
+    array.FillLayer(layer, placeholder);
+    queue({ path, &array, layer, 0 });
+}
+
+GLuint TextureLoader::Load2D(const std::string& path, const glm::vec3& placeholder) {
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    GLint previousAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    unsigned char texel[3] = { (unsigned char)(placeholder.r * 255.0f + 0.5f),
+                               (unsigned char)(placeholder.g * 255.0f + 0.5f),
+                               (unsigned char)(placeholder.b * 255.0f + 0.5f) };
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, texel);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    queue({ path, nullptr, 0, texture });
+    return texture;
+}
+
+void TextureLoader::threadLoop() {
+    while (true) {
+        Image image;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queued.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping)
+                return;
+            image.request = requests.front();
+            requests.pop_front();
+        }
+
+        decode(image);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.push_back(std::move(image));
+        }
+        decoded.notify_all();
+    }
+}
+
+// Read the cooked texture when the target takes one, otherwise decode to RGB,
+// resize for array layers and build the mip chain down to 1x1
+void TextureLoader::decode(Image& image) const {
+    const Request& request = image.request;
+    std::string cookedPath = CookedTexture::PathFor(request.path);
+    int cookedWidth, cookedHeight;
+    if (request.array ? request.array->compressed
+                      : s3tc && CookedTexture::ReadHeader(cookedPath, cookedWidth, cookedHeight)) {
+        // Larger maps fill the layer from the mip that matches the array
+        int firstLevel = 0;
+        if (request.array) {
+            if (CookedTexture::ReadHeader(cookedPath, cookedWidth, cookedHeight))
+                firstLevel = CookedTexture::FindLevel(cookedWidth, cookedHeight, request.array->width, request.array->height);
+            if (firstLevel < 0) {
+                std::cout << "ERROR::TEXTURE_LOADER::SIZE_MISMATCH: " << cookedPath << std::endl;
+                return;
+            }
+        }
+        if (!image.cooked.Load(cookedPath, firstLevel))
+            return;
+        image.compressed = true;
+        image.valid = true;
+        return;
+    }
+
+    int width = request.array ? request.array->width : 0;
+    int height = request.array ? request.array->height : 0;
+    if (!image.rgb.Load(request.path, width, height)) {
+        std::cout << "Failed to load texture: " << request.path << std::endl;
+        return;
+    }
+    image.rgb.BuildMips();
+    image.valid = true;
+}
+
+// Copy all levels into the PBO once, then let the driver pull them from it.
+// Cooked levels are copied straight from the file (or AssetPack mapping).
+void TextureLoader::upload(const Image& image) {
+    const CookedTexture& cooked = image.cooked;
+    const RgbImage& rgb = image.rgb;
+    GLsizeiptr size = (GLsizeiptr)(image.compressed ? cooked.getSize() : rgb.pixels.size());
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PBO);
+    if (size > pboCapacity) {
+        pboCapacity = size;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, pboCapacity, NULL, GL_STREAM_DRAW);
+    }
+    void* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!staging) {
+        std::cout << "ERROR::TEXTURE_LOADER::MAP_FAILED" << std::endl;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return;
+    }
+    std::vector<size_t> stagingOffsets;
+    if (image.compressed) {
+        size_t offset = 0;
+        for (int level = cooked.firstLevel; level <= cooked.lastLevel; ++level) {
+            stagingOffsets.push_back(offset);
+            std::memcpy((unsigned char*)staging + offset, cooked.getLevel(level), cooked.levelSizes[level]);
+            offset += cooked.levelSizes[level];
+        }
+    }
+    else {
+        std::memcpy(staging, rgb.pixels.data(), rgb.pixels.size());
+        stagingOffsets = rgb.levelOffsets;
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    GLint previousAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const Request& request = image.request;
+    int levels = (int)stagingOffsets.size();
+    if (request.array) {
+        request.array->Bind();
+        levels = std::min(levels, request.array->levels);
+    }
+    else {
+        glBindTexture(GL_TEXTURE_2D, request.texture);
+    }
+
+    for (int level = 0; level < levels; ++level) {
+        void* offset = (void*)stagingOffsets[level];
+        if (image.compressed) {
+            int source = cooked.firstLevel + level;
+            int lw = cooked.getLevelWidth(source), lh = cooked.getLevelHeight(source);
+            GLsizei levelSize = (GLsizei)cooked.levelSizes[source];
+            if (request.array)
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, request.layer, lw, lh, 1,
+                    GL_COMPRESSED_RGB_S3TC_DXT1_EXT, levelSize, offset);
+            else
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, lw, lh, 0, levelSize, offset);
+        }
+        else {
+            int lw = rgb.getLevelWidth(level), lh = rgb.getLevelHeight(level);
+            if (request.array)
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, request.layer, lw, lh, 1, GL_RGB, GL_UNSIGNED_BYTE, offset);
+            else
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGB8, lw, lh, 0, GL_RGB, GL_UNSIGNED_BYTE, offset);
+        }
+    }
+    if (!request.array)
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+bool TextureLoader::Update(int maxUploads) {
+    for (int i = 0; i < maxUploads && outstanding > 0; ++i) {
+        Image image;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished.empty())
+                break;
+            image = std::move(finished.front());
+            finished.pop_front();
+        }
+        if (image.valid)
+            upload(image);
+        --outstanding;
+    }
+    return outstanding > 0;
+}
+
+void TextureLoader::Finish() {
+    while (Update(outstanding)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        decoded.wait(lock, [this] { return !finished.empty(); });
+    }
+}
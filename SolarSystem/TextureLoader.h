@@ -0,0 +1,96 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CookedTexture.h"
+#include "RgbImage.h"
+#include "TextureArray.h"
+
+// Loads textures in the background. Images are decoded, resized and mipmapped
+// on the loader's own threads, all at once, and Update() uploads finished ones
+// on the GL thread through a pixel buffer object. Targets show a solid
+// placeholder color until their image arrives.
+//
+// When the GPU supports S3TC, cooked textures (CookedTexture.h) next to the
+// requested image are read instead and uploaded as BC1 with no decoding;
+// compressed arrays take cooked textures only.
+//
+// Decoding a large JPEG takes far longer than a frame, so the loader does not
+// use the JobSystem: the render thread helps run queued jobs while it waits
+// in ParallelFor and would stall on a decode.
+class TextureLoader {
+public:
+    // threadCount 0 uses one thread per hardware thread
+    explicit TextureLoader(int threadCount = 0);
+
+    // Drops requests that have not started and joins the threads
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // True if the GPU samples BC1 and every path has a cooked texture with a
+    // width x height mip level, i.e. they can fill a compressed TextureArray.
+    // Layers of larger maps get that level and the ones below it.
+    bool CanLoadCompressed(const std::vector<std::string>& paths, int width, int height) const;
+
+    // Fills the layer with the placeholder now and queues path, resized to
+    // the array's resolution
+    void LoadLayer(TextureArray& array, int layer, const std::string& path, const glm::vec3& placeholder);
+
+    // Returns a GL_TEXTURE_2D showing the placeholder now and queues path at
+    // its own resolution; the texture is owned by the caller
+    GLuint Load2D(const std::string& path, const glm::vec3& placeholder);
+
+    // GL thread: uploads up to maxUploads finished images. Returns false once
+    // every queued image has been uploaded (or failed).
+    bool Update(int maxUploads = 1);
+
+    // Waits for and uploads everything queued (headless renderer, tools)
+    void Finish();
+
+private:
+    struct Request {
+        std::string path;
+        TextureArray* array;   // Layer target, or nullptr for texture
+        int layer;
+        GLuint texture;        // GL_TEXTURE_2D target
+    };
+
+    struct Image {
+        Request request;
+        bool valid = false;
+        bool compressed = false;   // cooked holds the levels, otherwise rgb
+        RgbImage rgb;
+        CookedTexture cooked;
+    };
+
+    bool s3tc = false;                  // EXT_texture_compression_s3tc, read before the threads start
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable queued;     // Requests waiting or stopping
+    std::condition_variable decoded;    // An image finished
+    std::deque<Request> requests;
+    std::deque<Image> finished;
+    int outstanding = 0;                // Queued but not uploaded yet (GL thread only)
+    bool stopping = false;
+
+    GLuint PBO = 0;
+    GLsizeiptr pboCapacity = 0;
+
+    void queue(const Request& request);
+    void threadLoop();
+    void decode(Image& image) const;
+    void upload(const Image& image);
+};
+
+#endif
@@ -0,0 +1,232 @@
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+#include "Bc1.h"
+#include "TextureArray.h"
+
+TextureStreamer::TextureStreamer(size_t budget)
+    : budget(budget)
+{
+    thread = std::thread(&TextureStreamer::threadLoop, this);
+}
+
+TextureStreamer::~TextureStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        reads.clear();
+    }
+    queued.notify_all();
+    thread.join();
+    for (Stream& stream : streams)
+        glDeleteTextures(1, &stream.texture);
+}
+
+int TextureStreamer::Add(const std::string& cookedPath, int tailWidth, int tailHeight) {
+    Stream stream;
+    if (!CookedTexture::ReadHeader(cookedPath, stream.width, stream.height))
+        return -1;
+    stream.tailLevel = CookedTexture::FindLevel(stream.width, stream.height, tailWidth, tailHeight);
+    if (stream.tailLevel <= 0)
+        return -1;
+    stream.path = cookedPath;
+    stream.levelCount = 1;
+    while ((std::max(stream.width, stream.height) >> stream.levelCount) > 0)
+        ++stream.levelCount;
+    stream.resident = stream.target = stream.tailLevel;
+    streams.push_back(stream);
+    return (int)streams.size() - 1;
+}
+
+void TextureStreamer::SetScreenRadius(int stream, float screenRadius) {
+    streams[stream].screenRadius = screenRadius;
+}
+
+size_t TextureStreamer::textureSize(const Stream& stream, int level) const {
+    size_t size = 0;
+    if (level < stream.tailLevel) {
+        for (int l = level; l < stream.levelCount; ++l)
+            size += bc1::CompressedSize(std::max(1, stream.width >> l), std::max(1, stream.height >> l));
+    }
+    return size;
+}
+
+// The map wraps the sphere once, so the visible face spans about 2 pi r
+// texels across for a body of projected radius r pixels. Over budget, the
+// smallest body on screen drops a level until everything fits.
+void TextureStreamer::chooseTargets() {
+    size_t total = 0;
+    for (Stream& stream : streams) {
+        float texels = 6.2831853f * stream.screenRadius;
+        int level = stream.tailLevel;
+        if (texels > 0.0f)
+            level = (int)std::floor(std::log2((float)stream.width / texels));
+        stream.target = std::min(std::max(level, stream.finestLevel), stream.tailLevel);
+        total += textureSize(stream, stream.target);
+    }
+
+    while (total > budget) {
+        Stream* smallest = nullptr;
+        for (Stream& stream : streams) {
+            if (stream.target < stream.tailLevel && (!smallest || stream.screenRadius < smallest->screenRadius))
+                smallest = &stream;
+        }
+        total -= textureSize(*smallest, smallest->target);
+        ++smallest->target;
+        total += textureSize(*smallest, smallest->target);
+    }
+}
+
+// One level at a time, coarsest first; a stream's first read carries its
+// tail too so the texture has a complete mip chain
+void TextureStreamer::queueReads() {
+    for (int index = 0; index < (int)streams.size(); ++index) {
+        Stream& stream = streams[index];
+        if (stream.pending || stream.target >= stream.resident)
+            continue;
+        int level = stream.resident - 1;
+        int lastLevel = stream.texture ? level : stream.levelCount - 1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            reads.push_back({ index, level, lastLevel, stream.path });
+        }
+        stream.pending = true;
+        ++pendingReads;
+        queued.notify_one();
+    }
+}
+
+void TextureStreamer::Update(int maxUploads) {
+    chooseTargets();
+
+    // Keep one level more than wanted against flicker, unless over budget or off screen
+    for (Stream& stream : streams) {
+        bool tight = residentBytes > budget || stream.screenRadius <= 0.0f;
+        int keep = tight ? stream.target : stream.target - 1;
+        if (stream.resident < keep)
+            evict(stream, keep);
+    }
+
+    queueReads();
+    for (int uploads = 0; blocking || uploads < maxUploads; ++uploads) {
+        Loaded result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (blocking)
+                finished.wait(lock, [this] { return !loaded.empty() || pendingReads == 0; });
+            if (loaded.empty())
+                break;
+            result = std::move(loaded.front());
+            loaded.pop_front();
+        }
+        --pendingReads;
+        upload(result);
+        if (blocking)
+            queueReads();
+    }
+}
+
+// Frees the levels finer than level; the whole texture once nothing beyond
+// the array's tail is wanted
+void TextureStreamer::evict(Stream& stream, int level) {
+    residentBytes -= textureSize(stream, stream.resident);
+    if (level >= stream.tailLevel) {
+        glDeleteTextures(1, &stream.texture);
+        stream.texture = 0;
+        stream.resident = stream.tailLevel;
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, stream.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    for (int l = stream.resident; l < level; ++l)
+        glCompressedTexImage2D(GL_TEXTURE_2D, l, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 0, 0, 0, 0, NULL);
+    stream.resident = level;
+    residentBytes += textureSize(stream, stream.resident);
+}
+
+// Gives up other streams' extra levels, smallest body first, until growth
+// fits the budget. The targets fit it together, so this always makes room
+// for a level a stream wants; dropping the read instead would queue it again
+// every frame without it ever fitting.
+void TextureStreamer::makeRoom(const Stream& growing, size_t growth) {
+    while (residentBytes + growth > budget) {
+        Stream* smallest = nullptr;
+        for (Stream& stream : streams) {
+            if (&stream != &growing && stream.resident < stream.target
+                && (!smallest || stream.screenRadius < smallest->screenRadius))
+                smallest = &stream;
+        }
+        if (!smallest)
+            return;
+        evict(*smallest, smallest->target);
+    }
+}
+
+// Uploads a read if it is still the next level the stream wants and fits the
+// budget; reads overtaken by evictions or a shrinking body are dropped
+void TextureStreamer::upload(Loaded& result) {
+    const Read& read = result.read;
+    Stream& stream = streams[read.stream];
+    stream.pending = false;
+    if (!result.valid) {
+        stream.finestLevel = stream.resident;   // Stop asking for levels that cannot be read
+        return;
+    }
+
+    bool next = read.firstLevel == stream.resident - 1 && (stream.texture || read.lastLevel == stream.levelCount - 1);
+    size_t growth = textureSize(stream, read.firstLevel) - textureSize(stream, stream.resident);
+    if (!next || read.firstLevel < stream.target)
+        return;
+    makeRoom(stream, growth);
+    if (residentBytes + growth > budget)
+        return;
+
+    if (!stream.texture) {
+        glGenTextures(1, &stream.texture);
+        glBindTexture(GL_TEXTURE_2D, stream.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, stream.levelCount - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    else {
+        glBindTexture(GL_TEXTURE_2D, stream.texture);
+    }
+
+    // Straight from the read (or AssetPack mapping); no staging copy for a single level
+    const CookedTexture& cooked = result.cooked;
+    for (int level = read.firstLevel; level <= read.lastLevel; ++level) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, cooked.getLevelWidth(level),
+            cooked.getLevelHeight(level), 0, (GLsizei)cooked.levelSizes[level], cooked.getLevel(level));
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, read.firstLevel);
+    stream.resident = read.firstLevel;
+    residentBytes += growth;
+}
+
+void TextureStreamer::threadLoop() {
+    while (true) {
+        Loaded result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queued.wait(lock, [this] { return stopping || !reads.empty(); });
+            if (stopping)
+                return;
+            result.read = reads.front();
+            reads.pop_front();
+        }
+
+        result.valid = result.cooked.Load(result.read.path, result.read.firstLevel, result.read.lastLevel);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            loaded.push_back(std::move(result));
+        }
+        finished.notify_all();
+    }
+}
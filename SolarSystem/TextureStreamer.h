@@ -0,0 +1,111 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <glad/glad.h>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CookedTexture.h"
+
+// Streams the mip levels of cooked surface maps that are larger than the
+// planet TextureArray. The array always holds every map from the level that
+// matches its resolution down (the "tail"); finer levels are read one at a
+// time on a background thread, coarsest first, as a body's projected size
+// asks for them, into a GL_TEXTURE_2D per map whose GL_TEXTURE_BASE_LEVEL is
+// the finest resident level. Levels no longer wanted are freed, and when the
+// wanted levels exceed the budget the smallest bodies on screen give up theirs
+// first, so texture memory follows what is on screen rather than map size.
+class TextureStreamer {
+public:
+    static const size_t DEFAULT_BUDGET = (size_t)256 << 20;
+
+    explicit TextureStreamer(size_t budget = DEFAULT_BUDGET);
+
+    // Drops queued reads, joins the thread and deletes the textures
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Registers a cooked map whose tail is tailWidth x tailHeight. Returns the
+    // stream index, or -1 if the map has no finer levels than that.
+    int Add(const std::string& cookedPath, int tailWidth, int tailHeight);
+
+    // Projected radius in pixels of the body using the stream (0 off screen)
+    void SetScreenRadius(int stream, float screenRadius);
+
+    // GL thread, once per frame: picks each stream's level, frees levels that
+    // are not wanted or do not fit the budget, queues the next finer level and
+    // uploads up to maxUploads finished reads
+    void Update(int maxUploads = 2);
+
+    // Texture holding the stream's finer levels (and a copy of its tail), or 0
+    // while only the array's levels are resident
+    GLuint getTexture(int stream) const { return streams[stream].texture; }
+
+    int getStreamCount() const { return (int)streams.size(); }
+    // Finest resident level of a stream (its tail level when getTexture is 0)
+    int getResidentLevel(int stream) const { return streams[stream].resident; }
+    // Bytes held by all streamed textures
+    size_t getResidentBytes() const { return residentBytes; }
+
+    size_t budget;           // VRAM allowed for streamed levels, tails in the array excluded
+    bool blocking = false;   // Update waits until every stream has its level (headless renderer)
+
+private:
+    struct Stream {
+        std::string path;
+        int width, height;       // Level 0
+        int levelCount;
+        int tailLevel;           // First level the texture array holds
+        int finestLevel = 0;     // Raised when a level cannot be read
+        GLuint texture = 0;
+        int resident;            // Finest resident level, tailLevel without a texture
+        int target;              // Level wanted this frame
+        float screenRadius = 0.0f;
+        bool pending = false;    // A read is queued or in flight
+    };
+
+    // Levels [firstLevel, lastLevel] of one stream
+    struct Read {
+        int stream;
+        int firstLevel;
+        int lastLevel;
+        std::string path;
+    };
+
+    struct Loaded {
+        Read read;
+        bool valid = false;
+        CookedTexture cooked;
+    };
+
+    std::vector<Stream> streams;
+    size_t residentBytes = 0;
+    int pendingReads = 0;             // Queued but not uploaded yet (GL thread only)
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable queued;   // Reads waiting or stopping
+    std::condition_variable finished; // A read completed
+    std::deque<Read> reads;
+    std::deque<Loaded> loaded;
+    bool stopping = false;
+
+    // Bytes of a stream's texture when level is its finest resident one
+    size_t textureSize(const Stream& stream, int level) const;
+
+    void chooseTargets();
+    void queueReads();
+    void evict(Stream& stream, int level);
+    void makeRoom(const Stream& growing, size_t growth);
+    void upload(Loaded& result);
+    void threadLoop();
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "TiledTexture.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "AssetPack.h"
+#include "Bc1.h"
+#include "JobSystem.h"
+
+static const char MAGIC[4] = { 'V', 'T', 'E', 'X' };
+
+struct TiledHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pageSize;
+    uint32_t border;
+    uint32_t levelCount;
+    uint32_t pageBytes;
+};
+
+static bool isPowerOfTwo(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+static int levelsFor(int width, int height) {
+    int levels = 1;
+    while ((width >> (levels - 1)) > TiledTexture::PAGE_SIZE || (height >> (levels - 1)) > TiledTexture::PAGE_SIZE)
+        ++levels;
+    return levels;
+}
+
+bool TiledTexture::Open(const std::string& path) {
+    TiledHeader header;
+    size_t fileSize;
+    AssetPack::Asset asset;
+    const AssetPack* pack = AssetPack::Mounted();
+    if (pack && pack->Find(path, asset)) {
+        mapped = asset.data;
+        fileSize = asset.size;
+        if (fileSize < sizeof(header))
+            return false;
+        std::memcpy(&header, mapped, sizeof(header));
+    }
+    else {
+        file.open(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        fileSize = (size_t)file.tellg();
+        file.seekg(0);
+        if (!file.read((char*)&header, sizeof(header)))
+            return false;
+    }
+
+    width = (int)header.width;
+    height = (int)header.height;
+    levelCount = (int)header.levelCount;
+    pageBytes = header.pageBytes;
+    dataOffset = (sizeof(header) + PAGE_ALIGNMENT - 1) & ~(PAGE_ALIGNMENT - 1);
+    bool valid = !std::memcmp(header.magic, MAGIC, 4) && header.version == VERSION
+        && header.pageSize == PAGE_SIZE && header.border == BORDER
+        && isPowerOfTwo(width) && isPowerOfTwo(height) && width >= PAGE_SIZE && height >= PAGE_SIZE
+        && levelCount == levelsFor(width, height)
+        && pageBytes == bc1::CompressedSize(PADDED_SIZE, PADDED_SIZE)
+        && pageOffset(levelCount, 0, 0) <= fileSize;
+    if (!valid)
+        std::cout << "ERROR::TILED_TEXTURE::INVALID_FILE: " << path << std::endl;
+    return valid;
+}
+
+// Pages are stored level by level, row by row
+size_t TiledTexture::pageOffset(int level, int x, int y) const {
+    size_t index = 0;
+    for (int l = 0; l < level; ++l)
+        index += (size_t)getPagesX(l) * getPagesY(l);
+    index += (size_t)y * getPagesX(level) + x;
+    return dataOffset + index * pageBytes;
+}
+
+bool TiledTexture::ReadPage(int level, int x, int y, unsigned char* out) {
+    size_t offset = pageOffset(level, x, y);
+    if (mapped) {
+        std::memcpy(out, mapped + offset, pageBytes);
+        return true;
+    }
+    file.seekg((std::streamoff)offset);
+    return (bool)file.read((char*)out, (std::streamsize)pageBytes);
+}
+
+bool TiledTexture::Write(const std::string& path, const RgbImage& image) {
+    if (!isPowerOfTwo(image.width) || !isPowerOfTwo(image.height)
+        || image.width < PAGE_SIZE || image.height < PAGE_SIZE) {
+        std::cout << "ERROR::TILED_TEXTURE::SIZE_NOT_POWER_OF_TWO: " << path << std::endl;
+        return false;
+    }
+
+    TiledTexture layout;
+    layout.width = image.width;
+    layout.height = image.height;
+    layout.levelCount = levelsFor(image.width, image.height);
+    layout.pageBytes = bc1::CompressedSize(PADDED_SIZE, PADDED_SIZE);
+    layout.dataOffset = (sizeof(TiledHeader) + PAGE_ALIGNMENT - 1) & ~(PAGE_ALIGNMENT - 1);
+
+    TiledHeader header;
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.width = (uint32_t)layout.width;
+    header.height = (uint32_t)layout.height;
+    header.pageSize = PAGE_SIZE;
+    header.border = BORDER;
+    header.levelCount = (uint32_t)layout.levelCount;
+    header.pageBytes = (uint32_t)layout.pageBytes;
+
+    std::ofstream out(path, std::ios::binary);
+    out.write((const char*)&header, sizeof(header));
+    static const char padding[PAGE_ALIGNMENT] = {};
+    out.write(padding, (std::streamsize)(layout.dataOffset - sizeof(header)));
+
+    // One level at a time: gather padded pages, compress them in parallel, write in order
+    for (int level = 0; level < layout.levelCount && out; ++level) {
+        const unsigned char* pixels = image.getLevel(level);
+        int levelWidth = image.getLevelWidth(level), levelHeight = image.getLevelHeight(level);
+        int pagesX = layout.getPagesX(level), pagesY = layout.getPagesY(level);
+        std::vector<unsigned char> pages((size_t)pagesX * pagesY * layout.pageBytes);
+
+        JobSystem::Get().ParallelFor(0, pagesX * pagesY, 1, [&](int begin, int end) {
+            std::vector<unsigned char> padded((size_t)PADDED_SIZE * PADDED_SIZE * 3);
+            for (int page = begin; page < end; ++page) {
+                int pageX = page % pagesX, pageY = page / pagesX;
+                for (int y = 0; y < PADDED_SIZE; ++y) {
+                    int sy = std::min(std::max(pageY * PAGE_SIZE + y - BORDER, 0), levelHeight - 1);
+                    for (int x = 0; x < PADDED_SIZE; ++x) {
+                        int sx = ((pageX * PAGE_SIZE + x - BORDER) % levelWidth + levelWidth) % levelWidth;
+                        std::memcpy(&padded[((size_t)y * PADDED_SIZE + x) * 3], pixels + ((size_t)sy * levelWidth + sx) * 3, 3);
+                    }
+                }
+                bc1::Encode(padded.data(), PADDED_SIZE, PADDED_SIZE, &pages[(size_t)page * layout.pageBytes]);
+            }
+        });
+        out.write((const char*)pages.data(), (std::streamsize)pages.size());
+    }
+    if (!out) {
+        std::cout << "ERROR::TILED_TEXTURE::WRITE_FAILED: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string TiledTexture::PathFor(const std::string& sourcePath) {
+    size_t dot = sourcePath.find_last_of('.');
+    size_t slash = sourcePath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return sourcePath + ".vtex";
+    return sourcePath.substr(0, dot) + ".vtex";
+}
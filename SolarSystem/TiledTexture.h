@@ -0,0 +1,58 @@
+#ifndef TILED_TEXTURE_H
+#define TILED_TEXTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "RgbImage.h"
+
+// Surface map pre-tiled for virtual texturing (VirtualTextureCache): every mip
+// level is cut into PAGE_SIZE x PAGE_SIZE pages with a BORDER texel apron
+// (wrapping horizontally, clamped vertically) so pages filter bilinearly on
+// their own, and each padded page is BC1 compressed to the same byte size.
+// Width and height must be powers of two of at least PAGE_SIZE; levels stop
+// at the one that fits in a single page.
+//
+// .vtex layout (little endian):
+//   char magic[4] = "VTEX", uint32 version, uint32 width, uint32 height,
+//   uint32 pageSize, uint32 border, uint32 levelCount, uint32 pageBytes
+//   pages, level by level (finest first), row by row, PAGE_ALIGNMENT aligned
+struct TiledTexture {
+    static const uint32_t VERSION = 1;
+    static const int PAGE_SIZE = 128;
+    static const int BORDER = 4;
+    static const int PADDED_SIZE = PAGE_SIZE + 2 * BORDER;
+    static const size_t PAGE_ALIGNMENT = 16;
+
+    int width = 0, height = 0;
+    int levelCount = 0;
+    size_t pageBytes = 0;
+
+    // Reads the header; pages are read from the file (or the mounted
+    // AssetPack) one at a time with ReadPage
+    bool Open(const std::string& path);
+
+    int getPagesX(int level) const { return (width >> level) > PAGE_SIZE ? (width >> level) / PAGE_SIZE : 1; }
+    int getPagesY(int level) const { return (height >> level) > PAGE_SIZE ? (height >> level) / PAGE_SIZE : 1; }
+
+    // Copies one compressed padded page into out (pageBytes); not thread safe
+    // for loose files, so one thread reads each TiledTexture
+    bool ReadPage(int level, int x, int y, unsigned char* out);
+
+    // Tiles and compresses every level of a mipmapped image
+    static bool Write(const std::string& path, const RgbImage& image);
+
+    // Tiled file next to a source image: assets/earth.jpg -> assets/earth.vtex
+    static std::string PathFor(const std::string& sourcePath);
+
+private:
+    std::ifstream file;
+    const unsigned char* mapped = nullptr;   // File contents when it is in the AssetPack
+    size_t dataOffset = 0;                   // First page
+
+    size_t pageOffset(int level, int x, int y) const;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Lock-free single-producer/single-consumer triple buffer. The writer fills
+// Back() and publishes it; the reader picks up the newest published slot with
+// Update() and reads Front(). Neither side ever waits: the writer always has
+// a free slot and the reader always sees a complete snapshot, skipping any
+// that were superseded before it looked.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer: slot to fill for the next publish
+    T& Back() { return slots[back]; }
+
+    // Writer: makes Back() the newest snapshot and takes the old middle slot
+    void Publish() {
+        int previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+    }
+
+    // Reader: swaps in the newest snapshot; false if nothing new was published
+    bool Update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        int previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX_MASK;
+        return true;
+    }
+
+    // Reader: snapshot taken by the last Update()
+    const T& Front() const { return slots[front]; }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;   // Middle slot was published since the reader last took it
+
+    T slots[3];
+    std::atomic<int> middle{ 1 };  // Shared slot index plus FRESH flag
+    int front = 0;                 // Owned by the reader
+    int back = 2;                  // Owned by the writer
+};
+
+#endif
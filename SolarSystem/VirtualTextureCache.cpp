@@ -0,0 +1,382 @@
+#include "VirtualTextureCache.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+#include "TextureArray.h"
+
+VirtualTextureCache::VirtualTextureCache(int cachePages)
+    : feedbackShader("planet.vs", "planet_feedback.fs")
+{
+    // Slot coordinates go through 8-bit indirection texels
+    GLint maxSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    this->cachePages = std::max(1, std::min(std::min(cachePages, 255), maxSize / TiledTexture::PADDED_SIZE));
+    slots.resize((size_t)this->cachePages * this->cachePages);
+
+    int size = this->cachePages * TiledTexture::PADDED_SIZE;
+    glGenTextures(1, &cacheTexture);
+    glBindTexture(GL_TEXTURE_2D, cacheTexture);
+    glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, size, size, 0,
+        (GLsizei)((size_t)size / 4 * (size / 4) * 8), NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // The feedback target has FEEDBACK_DOWNSCALE times fewer pixels per axis,
+    // so its derivatives select pages that many levels too coarse
+    feedbackShader.Use();
+    feedbackShader.setInt("detailTexture", 1);
+    feedbackShader.setFloat("feedbackBias", -std::log2((float)FEEDBACK_DOWNSCALE));
+    glGenBuffers(2, feedbackBuffers);
+
+    thread = std::thread(&VirtualTextureCache::threadLoop, this);
+}
+
+VirtualTextureCache::~VirtualTextureCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        reads.clear();
+    }
+    queued.notify_all();
+    thread.join();
+    for (Map& map : maps)
+        glDeleteTextures(1, &map.indirection);
+    glDeleteTextures(1, &cacheTexture);
+    glDeleteBuffers(2, feedbackBuffers);
+    delete feedbackTarget;
+}
+
+// 8 bits of map and level, 20 of page row and column
+uint64_t VirtualTextureCache::pageKey(int map, int level, int x, int y) {
+    return (uint64_t)map << 48 | (uint64_t)level << 40 | (uint64_t)y << 20 | (uint64_t)x;
+}
+
+void VirtualTextureCache::unpackKey(uint64_t page, int& map, int& level, int& x, int& y) {
+    map = (int)(page >> 48 & 0xFF);
+    level = (int)(page >> 40 & 0xFF);
+    y = (int)(page >> 20 & 0xFFFFF);
+    x = (int)(page & 0xFFFFF);
+}
+
+int VirtualTextureCache::Add(const std::string& tiledPath) {
+    maps.emplace_back();
+    Map& map = maps.back();
+    int index = (int)maps.size() - 1;
+    // Feedback pixels carry the map in 8 bits (0 is "no page") and page coordinates in 8 bits each
+    if (index >= 255 || !map.file.Open(tiledPath)) {
+        maps.pop_back();
+        return -1;
+    }
+    const TiledTexture& file = map.file;
+    if (file.getPagesX(0) > 256 || file.getPagesY(0) > 256) {
+        std::cout << "ERROR::VIRTUAL_TEXTURE::TOO_MANY_PAGES: " << tiledPath << std::endl;
+        maps.pop_back();
+        return -1;
+    }
+
+    size_t entryCount = 0;
+    for (int level = 0; level < file.levelCount; ++level) {
+        map.levelStart.push_back(entryCount);
+        entryCount += (size_t)file.getPagesX(level) * file.getPagesY(level);
+    }
+    map.entries.resize(entryCount);
+
+    // One texel per page, nearest filtered so entries are never blended
+    glGenTextures(1, &map.indirection);
+    glBindTexture(GL_TEXTURE_2D, map.indirection);
+    for (int level = 0; level < file.levelCount; ++level) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, file.getPagesX(level), file.getPagesY(level), 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, file.levelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // Coarsest page up front, so every lookup resolves from the first frame
+    Loaded top;
+    top.page = pageKey(index, file.levelCount - 1, 0, 0);
+    top.data.resize(file.pageBytes);
+    top.valid = map.file.ReadPage(file.levelCount - 1, 0, 0, top.data.data());
+    upload(top);
+    auto slot = resident.find(top.page);
+    if (slot == resident.end()) {
+        std::cout << "ERROR::VIRTUAL_TEXTURE::NO_COARSEST_PAGE: " << tiledPath << std::endl;
+        glDeleteTextures(1, &map.indirection);
+        maps.pop_back();
+        return -1;
+    }
+    slots[slot->second].pinned = true;
+    updateIndirection(map, index);
+    return index;
+}
+
+void VirtualTextureCache::RenderFeedback(int viewportWidth, int viewportHeight, const std::function<void()>& draw) {
+    int width = std::max(1, viewportWidth / FEEDBACK_DOWNSCALE);
+    int height = std::max(1, viewportHeight / FEEDBACK_DOWNSCALE);
+    GLint previousDraw, previousRead, previousProgram, previousViewport[4];
+    GLfloat previousClearColor[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDraw);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor);
+
+    if (!feedbackTarget || feedbackTarget->width != width || feedbackTarget->height != height) {
+        delete feedbackTarget;
+        feedbackTarget = new Framebuffer(width, height);
+    }
+
+    // Zero is "no page"; other bodies still write depth and hide what they cover
+    feedbackTarget->Bind();
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    feedbackShader.Use();
+    draw();
+
+    // Asynchronous readback; Update maps the buffer a frame later
+    feedbackIndex = 1 - feedbackIndex;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, feedbackBuffers[feedbackIndex]);
+    glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, NULL, GL_STREAM_READ);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    feedbackWidth[feedbackIndex] = width;
+    feedbackHeight[feedbackIndex] = height;
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDraw);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+    glUseProgram(previousProgram);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    glClearColor(previousClearColor[0], previousClearColor[1], previousClearColor[2], previousClearColor[3]);
+}
+
+// Decodes a feedback buffer into the set of sampled pages, marks them and
+// their resident ancestors used this frame and lists the missing ones
+void VirtualTextureCache::collectRequests(int buffer) {
+    int width = feedbackWidth[buffer], height = feedbackHeight[buffer];
+    if (width == 0)
+        return;
+    feedbackWidth[buffer] = feedbackHeight[buffer] = 0;
+
+    requests.clear();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, feedbackBuffers[buffer]);
+    const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+        (GLsizeiptr)width * height * 4, GL_MAP_READ_BIT);
+    if (pixels) {
+        // Neighbouring pixels mostly hit the same page
+        const unsigned char* previous = nullptr;
+        for (size_t i = 0; i < (size_t)width * height; ++i) {
+            const unsigned char* pixel = pixels + i * 4;
+            if (pixel[3] == 0 || (previous && std::equal(pixel, pixel + 4, previous)))
+                continue;
+            previous = pixel;
+            int mapIndex = pixel[3] - 1, level = pixel[2], x = pixel[0], y = pixel[1];
+            if (mapIndex >= (int)maps.size())
+                continue;
+            const TiledTexture& file = maps[mapIndex].file;
+            if (level < file.levelCount && x < file.getPagesX(level) && y < file.getPagesY(level))
+                requests.push_back(pageKey(mapIndex, level, x, y));
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    std::sort(requests.begin(), requests.end());
+    requests.erase(std::unique(requests.begin(), requests.end()), requests.end());
+
+    // Ancestors are wanted too: they are the fallback while a page loads
+    std::unordered_set<uint64_t> visited;
+    missing.clear();
+    for (uint64_t page : requests) {
+        int mapIndex, level, x, y;
+        unpackKey(page, mapIndex, level, x, y);
+        for (int l = level; l < maps[mapIndex].file.levelCount; ++l, x /= 2, y /= 2) {
+            uint64_t key = pageKey(mapIndex, l, x, y);
+            if (!visited.insert(key).second)
+                break;
+            auto slot = resident.find(key);
+            if (slot != resident.end())
+                slots[slot->second].lastUsed = frame;
+            else if (!failed.count(key))
+                missing.push_back(key);
+        }
+    }
+    std::sort(missing.begin(), missing.end(), [](uint64_t a, uint64_t b) {
+        return (a >> 40 & 0xFF) > (b >> 40 & 0xFF);
+    });
+}
+
+// Reads as many missing pages as there are slots to put them in
+void VirtualTextureCache::queueReads() {
+    if (full)
+        return;
+    int available = 0;
+    for (const Slot& slot : slots) {
+        if (!slot.used || (!slot.pinned && slot.lastUsed < frame))
+            ++available;
+    }
+    available -= (int)pending.size();
+
+    bool added = false;
+    for (uint64_t page : missing) {
+        if (available <= 0 || (int)pending.size() >= MAX_PENDING_READS)
+            break;
+        if (resident.count(page) || pending.count(page) || failed.count(page))
+            continue;
+        int mapIndex, level, x, y;
+        unpackKey(page, mapIndex, level, x, y);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            reads.push_back({ page, &maps[mapIndex].file });
+        }
+        pending.insert(page);
+        --available;
+        added = true;
+    }
+    if (added)
+        queued.notify_one();
+}
+
+void VirtualTextureCache::Update(int maxUploads) {
+    ++frame;
+    full = false;
+    collectRequests(blocking ? feedbackIndex : 1 - feedbackIndex);
+
+    queueReads();
+    for (int uploads = 0; blocking || uploads < maxUploads; ++uploads) {
+        Loaded result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (blocking)
+                finished.wait(lock, [this] { return !loaded.empty() || pending.empty(); });
+            if (loaded.empty())
+                break;
+            result = std::move(loaded.front());
+            loaded.pop_front();
+        }
+        upload(result);
+        if (blocking)
+            queueReads();
+    }
+
+    for (int index = 0; index < (int)maps.size(); ++index) {
+        if (maps[index].dirty)
+            updateIndirection(maps[index], index);
+    }
+    requestedPages = (int)requests.size();
+    requestedResident = 0;
+    for (uint64_t page : requests)
+        requestedResident += (int)resident.count(page);
+}
+
+// A free slot, else the least recently used page not sampled this frame; -1 if
+// every slot is pinned or in use
+int VirtualTextureCache::allocateSlot() {
+    int best = -1;
+    for (int index = 0; index < (int)slots.size(); ++index) {
+        const Slot& slot = slots[index];
+        if (!slot.used)
+            return index;
+        if (!slot.pinned && slot.lastUsed < frame && (best < 0 || slot.lastUsed < slots[best].lastUsed))
+            best = index;
+    }
+    if (best >= 0) {
+        int mapIndex, level, x, y;
+        unpackKey(slots[best].page, mapIndex, level, x, y);
+        maps[mapIndex].dirty = true;
+        resident.erase(slots[best].page);
+        slots[best].used = false;
+    }
+    return best;
+}
+
+void VirtualTextureCache::upload(Loaded& result) {
+    pending.erase(result.page);
+    if (!result.valid) {
+        failed.insert(result.page);   // Stop asking for pages that cannot be read
+        return;
+    }
+    if (resident.count(result.page))
+        return;
+    int slot = allocateSlot();
+    if (slot < 0) {
+        full = true;
+        return;
+    }
+
+    int x = slot % cachePages, y = slot / cachePages;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, cacheTexture);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, x * TiledTexture::PADDED_SIZE, y * TiledTexture::PADDED_SIZE,
+        TiledTexture::PADDED_SIZE, TiledTexture::PADDED_SIZE, GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+        (GLsizei)result.data.size(), result.data.data());
+    slots[slot].page = result.page;
+    slots[slot].lastUsed = frame;
+    slots[slot].used = true;
+    resident[result.page] = slot;
+
+    int mapIndex, level, pageX, pageY;
+    unpackKey(result.page, mapIndex, level, pageX, pageY);
+    maps[mapIndex].dirty = true;
+}
+
+// Coarsest level first: a resident page points at its own slot, any other at
+// the entry of its parent, i.e. the finest resident ancestor
+void VirtualTextureCache::updateIndirection(Map& map, int mapIndex) {
+    const TiledTexture& file = map.file;
+    glBindTexture(GL_TEXTURE_2D, map.indirection);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (int level = file.levelCount - 1; level >= 0; --level) {
+        int pagesX = file.getPagesX(level), pagesY = file.getPagesY(level);
+        uint32_t* entries = &map.entries[map.levelStart[level]];
+        const uint32_t* parent = level + 1 < file.levelCount ? &map.entries[map.levelStart[level + 1]] : nullptr;
+        int parentPagesX = level + 1 < file.levelCount ? file.getPagesX(level + 1) : 1;
+        for (int y = 0; y < pagesY; ++y) {
+            for (int x = 0; x < pagesX; ++x) {
+                auto slot = resident.find(pageKey(mapIndex, level, x, y));
+                if (slot != resident.end()) {
+                    uint32_t slotX = (uint32_t)(slot->second % cachePages), slotY = (uint32_t)(slot->second / cachePages);
+                    entries[y * pagesX + x] = slotX | slotY << 8 | (uint32_t)level << 16 | 0xFF000000u;
+                }
+                else {
+                    entries[y * pagesX + x] = parent ? parent[(y / 2) * parentPagesX + x / 2] : 0;
+                }
+            }
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, pagesX, pagesY, GL_RGBA, GL_UNSIGNED_BYTE, entries);
+    }
+    map.dirty = false;
+}
+
+void VirtualTextureCache::threadLoop() {
+    while (true) {
+        Read read;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queued.wait(lock, [this] { return stopping || !reads.empty(); });
+            if (stopping)
+                return;
+            read = reads.front();
+            reads.pop_front();
+        }
+
+        Loaded result;
+        result.page = read.page;
+        result.data.resize(read.file->pageBytes);
+        int mapIndex, level, x, y;
+        unpackKey(read.page, mapIndex, level, x, y);
+        result.valid = read.file->ReadPage(level, x, y, result.data.data());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            loaded.push_back(std::move(result));
+        }
+        finished.notify_all();
+    }
+}
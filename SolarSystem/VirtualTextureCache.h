@@ -0,0 +1,144 @@
+#ifndef VIRTUAL_TEXTURE_CACHE_H
+#define VIRTUAL_TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Framebuffer.h"
+#include "Shader.h"
+#include "TiledTexture.h"
+
+// Virtual texturing of pre-tiled surface maps (TiledTexture). Only the pages
+// the frame samples are resident, in one fixed-size BC1 page cache texture
+// shared by every map, so VRAM stays constant whatever the map resolution.
+//
+// Each frame the planets are drawn once more into a small feedback target with
+// planet_feedback.fs, which writes the page (map, level, x, y) every pixel
+// samples. The target is read back through a pixel buffer a frame later, the
+// missing pages are read on a background thread, coarsest first, and
+// uploaded into free or least recently used cache slots. A mipmapped RGBA8
+// indirection texture per map (one texel per page) points planet.fs at the
+// slot holding each page, or at its finest resident ancestor until it
+// arrives; the single page of the coarsest level stays resident.
+class VirtualTextureCache {
+public:
+    static const int DEFAULT_CACHE_PAGES = 32;   // Slots per side: 1024 pages, 9 MB
+    static const int FEEDBACK_DOWNSCALE = 4;     // Feedback target is 1/4 of the viewport per axis
+
+    explicit VirtualTextureCache(int cachePages = DEFAULT_CACHE_PAGES);
+
+    // Drops queued reads, joins the thread and deletes the textures
+    ~VirtualTextureCache();
+
+    VirtualTextureCache(const VirtualTextureCache&) = delete;
+    VirtualTextureCache& operator=(const VirtualTextureCache&) = delete;
+
+    // Registers a tiled map and makes its coarsest page resident. Returns the
+    // map index, or -1 if the file is missing or invalid.
+    int Add(const std::string& tiledPath);
+
+    // Per-instance texture layer planet.vs receives for a map; planet.fs reads
+    // layers <= -2 as "virtual" with the indirection texture on unit 1
+    static int InstanceLayer(int map) { return -2 - map; }
+
+    // Draws the frame's planets (draw must issue them with the current program)
+    // into the feedback target with the feedback shader, then starts reading it
+    // back. Restores the framebuffer and viewport.
+    void RenderFeedback(int viewportWidth, int viewportHeight, const std::function<void()>& draw);
+
+    // GL thread, after RenderFeedback: collects the pages of the last feedback
+    // that finished reading back, queues the missing ones and uploads up to
+    // maxUploads of them, then refreshes the indirection textures
+    void Update(int maxUploads = 16);
+
+    GLuint getIndirection(int map) const { return maps[map].indirection; }
+    GLuint getCacheTexture() const { return cacheTexture; }
+    int getCachePages() const { return cachePages; }
+
+    int getMapCount() const { return (int)maps.size(); }
+    // Cache slots holding a page
+    int getResidentPages() const { return (int)resident.size(); }
+    int getCapacity() const { return cachePages * cachePages; }
+    // Pages requested by the last feedback, and how many of them are resident
+    int getRequestedPages() const { return requestedPages; }
+    int getRequestedResident() const { return requestedResident; }
+
+    bool blocking = false;   // Update reads this frame's feedback and waits for its pages (headless renderer)
+
+private:
+    static const int MAX_PENDING_READS = 64;
+
+    struct Map {
+        TiledTexture file;
+        GLuint indirection = 0;
+        std::vector<size_t> levelStart;   // First entry of each level in entries
+        std::vector<uint32_t> entries;    // RGBA8 indirection texels, level by level
+        bool dirty = true;
+    };
+
+    struct Slot {
+        uint64_t page = 0;
+        uint64_t lastUsed = 0;   // Frame that last sampled the page
+        bool used = false;
+        bool pinned = false;     // Coarsest page of a map, never evicted
+    };
+
+    struct Read {
+        uint64_t page;
+        TiledTexture* file;
+    };
+
+    struct Loaded {
+        uint64_t page;
+        bool valid;
+        std::vector<unsigned char> data;
+    };
+
+    int cachePages;
+    GLuint cacheTexture = 0;
+    std::deque<Map> maps;   // Stable addresses for the reader thread
+    std::vector<Slot> slots;
+    std::unordered_map<uint64_t, int> resident;   // Page -> slot
+    std::unordered_set<uint64_t> pending;         // Queued or in flight
+    std::unordered_set<uint64_t> failed;          // Pages that could not be read
+    std::vector<uint64_t> requests;               // Pages sampled by the last feedback
+    std::vector<uint64_t> missing;                // Wanted but not resident, coarsest first
+    uint64_t frame = 0;
+    bool full = false;   // No slot could be freed for an upload this frame
+    int requestedPages = 0, requestedResident = 0;
+
+    Shader feedbackShader;
+    Framebuffer* feedbackTarget = nullptr;
+    GLuint feedbackBuffers[2] = {};   // Pixel buffers the feedback is read into, alternating per frame
+    int feedbackWidth[2] = {}, feedbackHeight[2] = {};
+    int feedbackIndex = 0;            // Buffer written by the last RenderFeedback
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable queued;   // Reads waiting or stopping
+    std::condition_variable finished; // A read completed
+    std::deque<Read> reads;
+    std::deque<Loaded> loaded;
+    bool stopping = false;
+
+    static uint64_t pageKey(int map, int level, int x, int y);
+    static void unpackKey(uint64_t page, int& map, int& level, int& x, int& y);
+
+    void collectRequests(int buffer);
+    void queueReads();
+    int allocateSlot();
+    void upload(Loaded& result);
+    void updateIndirection(Map& map, int mapIndex);
+    void threadLoop();
+};
+
+#endif
@@ -0,0 +1,15 @@
+#version 330 core
+out vec4 FragColor;
+
+in float fade;
+
+uniform vec3 asteroidColor;
+
+void main()
+{
+    // Round sprite: drop the corners of the point square
+    vec2 offset = gl_PointCoord - vec2(0.5);
+    if (dot(offset, offset) > 0.25)
+        discard;
+    FragColor = vec4(asteroidColor * fade, 1.0);
+}
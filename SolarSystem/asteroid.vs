@@ -0,0 +1,24 @@
+#version 330 core
+layout (location = 0) in vec3 position;
+
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 cameraPosition;
+    vec4 viewport;
+};
+
+uniform float pointScale;   // Sprite diameter in pixels at distance 1
+
+out float fade;
+
+void main()
+{
+    vec4 viewPosition = view * vec4(position, 1.0);
+    gl_Position = projection * viewPosition;
+
+    // Shrink with distance but never below one pixel; far points also dim
+    float distance = max(-viewPosition.z, 1.0);
+    gl_PointSize = clamp(pointScale / distance, 1.0, 4.0);
+    fade = clamp(pointScale / distance, 0.35, 1.0);
+}
@@ -0,0 +1,37 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Benchmarks linked into solarsystem_bench; each returns 0 on success.
+// They run from the SolarSystem directory so shader files are found.
+
+// Uniform setter throughput: driver lookup vs cached name vs location
+int benchShaderUniforms();
+
+// Direct-sum gravity kernels: scalar vs SIMD at several body counts
+int benchNBody();
+
+// Barnes-Hut tree build and force pass at 10k/100k/1M bodies
+int benchBarnesHut();
+
+// JobSystem ParallelFor scaling by worker count and dispatch overhead
+int benchJobSystem();
+
+// Kepler propagation of 10k/100k/1M bodies and its accuracy
+int benchKepler();
+
+// The same on the GPU: transform feedback propagation time and accuracy
+int benchKeplerFeedback();
+
+// Orbit line loops: one draw per orbit vs a single OrbitBatch multi-draw,
+// with and without screen-space levels of detail
+int benchOrbitBatch();
+
+// Mip streaming of a large cooked map: per-level read + upload time,
+// eviction and budget enforcement
+int benchTextureStreaming();
+
+// Virtual texturing of a large tiled map: feedback + page upload time per
+// view, residency against the pages asked for, and image error
+int benchVirtualTexture();
+
+#endif
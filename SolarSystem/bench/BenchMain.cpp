@@ -0,0 +1,38 @@
+// solarsystem_bench: runs every benchmark, or only those named on the command line.
+#include <cstring>
+#include <iostream>
+
+#include "Bench.h"
+
+struct BenchEntry {
+    const char* name;
+    int (*run)();
+};
+
+static const BenchEntry benches[] = {
+    { "uniforms", benchShaderUniforms },
+    { "nbody", benchNBody },
+    { "barneshut", benchBarnesHut },
+    { "jobs", benchJobSystem },
+    { "kepler", benchKepler },
+    { "keplergpu", benchKeplerFeedback },
+    { "orbits", benchOrbitBatch },
+    { "texstream", benchTextureStreaming },
+    { "virtualtex", benchVirtualTexture },
+};
+
+int main(int argc, char** argv) {
+    int result = 0;
+    for (const BenchEntry& bench : benches) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected |= std::strcmp(argv[i], bench.name) == 0;
+        if (!selected)
+            continue;
+
+        std::cout << "== " << bench.name << std::endl;
+        if (bench.run() != 0)
+            result = -1;
+    }
+    return result;
+}
@@ -0,0 +1,75 @@
+// Microbenchmark: JobSystem scaling on a compute-bound ParallelFor (pairwise
+// inverse distances, like the gravity kernel) for several worker counts, plus
+// the fixed cost of dispatching and joining a small ParallelFor.
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "JobSystem.h"
+
+static const int ITEMS = 4096;
+static const int REPEATS = 8;
+
+// Sum of inverse distances from every point to all others, split over rows
+static double workload(JobSystem& jobs, const std::vector<float>& points, std::vector<float>& out) {
+    jobs.ParallelFor(0, ITEMS, 16, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            float sum = 0.0f;
+            for (int j = 0; j < ITEMS; ++j) {
+                float d = points[i] - points[j];
+                sum += 1.0f / std::sqrt(d * d + 0.01f);
+            }
+            out[i] = sum;
+        }
+    });
+    double total = 0.0;
+    for (float value : out)
+        total += value;
+    return total;
+}
+
+int benchJobSystem() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    std::cout << "hardware threads: " << hardware << std::endl;
+
+    std::vector<float> points(ITEMS), out(ITEMS);
+    for (int i = 0; i < ITEMS; ++i)
+        points[i] = std::sin(i * 0.37f) * 100.0f;
+
+    int result = 0;
+    double reference = 0.0, serialMs = 0.0;
+    for (int workers : { 0, 1, 3, 7, 15, 31 }) {
+        if (workers > 0 && (unsigned)workers >= hardware * 2)
+            break;
+
+        JobSystem jobs(workers);
+        double total = workload(jobs, points, out);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < REPEATS; ++i)
+            total = workload(jobs, points, out);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / REPEATS;
+
+        if (workers == 0) {
+            reference = total;
+            serialMs = ms;
+        }
+        else if (std::fabs(total - reference) > 1e-6 * std::fabs(reference)) {
+            std::cout << "ERROR::JOBS::RESULT_MISMATCH" << std::endl;
+            result = -1;
+        }
+        std::cout << workers << " workers + caller: " << ms << " ms (" << serialMs / ms << "x)" << std::endl;
+    }
+
+    // Dispatch overhead: tiny ranges split into one job per worker
+    JobSystem jobs(hardware > 1 ? (int)hardware - 1 : 1);
+    const int DISPATCHES = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < DISPATCHES; ++i)
+        jobs.ParallelFor(0, jobs.getWorkerCount() + 1, 1, [](int, int) {});
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / DISPATCHES;
+    std::cout << "ParallelFor dispatch with " << jobs.getWorkerCount() << " workers: " << us << " us" << std::endl;
+    return result;
+}
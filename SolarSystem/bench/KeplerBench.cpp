@@ -0,0 +1,156 @@
+// Microbenchmark: closed-form Kepler propagation of many bodies (SIMD solver
+// on the job system) and its accuracy against a double-precision solution,
+// plus the same on the GPU with transform feedback.
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "Framebuffer.h"
+#include "HeadlessContext.h"
+#include "Kepler.h"
+#include "KeplerFeedback.h"
+
+// Asteroid-belt-like elements with eccentricities up to 0.9
+static OrbitalElements randomOrbit(std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    OrbitalElements orbit;
+    orbit.semiMajorAxis = 115.0f + 30.0f * unit(rng);
+    orbit.eccentricity = 0.9f * unit(rng) * unit(rng);
+    orbit.inclination = 0.3f * unit(rng);
+    orbit.ascendingNode = 6.2831853f * unit(rng);
+    orbit.periapsis = 6.2831853f * unit(rng);
+    orbit.meanAnomaly = 6.2831853f * unit(rng);
+    orbit.meanMotion = 0.3f + 0.2f * unit(rng);
+    return orbit;
+}
+
+// Reference position: Newton in double until converged
+static glm::dvec3 referencePosition(const OrbitalElements& orbit, double t) {
+    const double twoPi = 6.283185307179586;
+    double M = orbit.meanAnomaly + (double)orbit.meanMotion * t;
+    M -= twoPi * std::floor((M + twoPi / 2) / twoPi);
+    double e = orbit.eccentricity;
+    double E = M + e * std::sin(M);
+    for (int k = 0; k < 50; ++k)
+        E -= (E - e * std::sin(E) - M) / (1.0 - e * std::cos(E));
+
+    glm::vec3 P, Q;
+    orbit.GetBasis(P, Q);
+    double u = orbit.semiMajorAxis * (std::cos(E) - e);
+    double v = orbit.semiMajorAxis * std::sqrt(1.0 - e * e) * std::sin(E);
+    return glm::dvec3(P) * u + glm::dvec3(Q) * v;
+}
+
+int benchKepler() {
+    int result = 0;
+    for (int count : { 10000, 100000, 1000000 }) {
+        std::mt19937 rng(42);
+        std::vector<OrbitalElements> orbits(count);
+        KeplerBatch batch;
+        for (OrbitalElements& orbit : orbits) {
+            orbit = randomOrbit(rng);
+            batch.Add(orbit);
+        }
+        std::vector<float> x(count), y(count), z(count);
+
+        double t = 1234.5;
+        int calls = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        do {
+            batch.Propagate(t + calls * 0.01, x.data(), y.data(), z.data());
+            ++calls;
+            elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < 200.0);
+        double ms = elapsed / calls;
+
+        // Largest position error, in scene units, over a sample of bodies
+        batch.Propagate(t, x.data(), y.data(), z.data());
+        double maxError = 0.0;
+        for (int i = 0; i < count; i += std::max(1, count / 1000)) {
+            glm::dvec3 exact = referencePosition(orbits[i], t);
+            glm::dvec3 error = glm::dvec3(x[i], y[i], z[i]) - exact;
+            maxError = std::max(maxError, std::sqrt(glm::dot(error, error)));
+        }
+
+        std::cout << count << " bodies: " << ms << " ms (" << ms * 1e6 / count << " ns/body), max error "
+            << maxError << std::endl;
+        if (maxError > 1e-2) {
+            std::cout << "ERROR::KEPLER::INACCURATE" << std::endl;
+            result = -1;
+        }
+    }
+    return result;
+}
+
+int benchKeplerFeedback() {
+    HeadlessContext context;
+    if (!context.isValid())
+        return -1;
+    std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    // Surfaceless contexts have no default framebuffer and draws need a complete
+    // one even with rasterizer discard
+    Framebuffer target(16, 16);
+    target.Bind();
+
+    int result = 0;
+    for (int count : { 10000, 100000, 1000000 }) {
+        std::mt19937 rng(42);
+        std::vector<OrbitalElements> orbits(count);
+        KeplerBatch batch;
+        for (OrbitalElements& orbit : orbits) {
+            orbit = randomOrbit(rng);
+            batch.Add(orbit);
+        }
+        KeplerFeedback feedback(batch);
+
+        GLuint output;
+        glGenBuffers(1, &output);
+        glBindBuffer(GL_ARRAY_BUFFER, output);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)count * 3 * sizeof(float), NULL, GL_DYNAMIC_COPY);
+
+        double t = 1234.5;
+        int calls = 0;
+        glFinish();
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        do {
+            feedback.Propagate(t + calls * 0.01, output);
+            glFinish();
+            ++calls;
+            elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < 200.0);
+        double ms = elapsed / calls;
+
+        // Largest position error at a small and a large time (the split time
+        // uniforms should keep the mean anomaly accurate for both)
+        std::vector<float> positions((size_t)count * 3);
+        double maxError = 0.0;
+        for (double when : { t, 1.0e6 }) {
+            feedback.Propagate(when, output);
+            glBindBuffer(GL_ARRAY_BUFFER, output);
+            glGetBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)positions.size() * sizeof(float), positions.data());
+            for (int i = 0; i < count; i += std::max(1, count / 1000)) {
+                glm::dvec3 exact = referencePosition(orbits[i], when);
+                glm::dvec3 error = glm::dvec3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]) - exact;
+                maxError = std::max(maxError, std::sqrt(glm::dot(error, error)));
+            }
+        }
+        glDeleteBuffers(1, &output);
+
+        std::cout << count << " bodies: " << ms << " ms (" << ms * 1e6 / count << " ns/body), max error "
+            << maxError << std::endl;
+        if (maxError > 1e-2) {
+            std::cout << "ERROR::KEPLER_FEEDBACK::INACCURATE" << std::endl;
+            result = -1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,131 @@
+// Microbenchmarks for gravity: direct-sum kernel throughput (scalar reference
+// vs the compiled-in SIMD kernel, checking the two agree since the SIMD path
+// uses an approximate reciprocal square root), and Barnes-Hut build/force cost
+// and accuracy at large body counts.
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "NBody.h"
+
+// Random disc of bodies, roughly like a planetary system seen from above
+static void populate(NBodySystem& system, int count) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < count; ++i) {
+        float r = 10.0f + 300.0f * unit(rng);
+        float angle = 6.2831853f * unit(rng);
+        glm::vec3 position(r * std::cos(angle), (unit(rng) - 0.5f) * 2.0f, -r * std::sin(angle));
+        system.AddBody(position, glm::vec3(0.0f), 1.0f + unit(rng));
+    }
+}
+
+// Runs fn repeatedly for at least ~0.2 s and returns milliseconds per call
+template <typename Fn>
+static double measure(Fn fn) {
+    int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        fn();
+        ++iterations;
+        elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 200.0);
+    return elapsed / iterations;
+}
+
+int benchNBody() {
+    std::cout << "SIMD kernel: " << NBodySystem::KernelName() << std::endl;
+
+    int result = 0;
+    for (int count : { 1024, 4096, 16384 }) {
+        NBodySystem system;
+        populate(system, count);
+
+        // Error of each acceleration vector relative to the RMS magnitude; the
+        // kernels sum in different orders, so nearly cancelling components differ
+        system.ComputeAccelerationsScalar();
+        std::vector<float> rx = system.ax, ry = system.ay, rz = system.az;
+        system.ComputeAccelerations();
+        double sumSquares = 0.0, maxErrorSquared = 0.0;
+        for (int i = 0; i < count; ++i) {
+            double ex = system.ax[i] - rx[i], ey = system.ay[i] - ry[i], ez = system.az[i] - rz[i];
+            sumSquares += (double)rx[i] * rx[i] + (double)ry[i] * ry[i] + (double)rz[i] * rz[i];
+            maxErrorSquared = std::max(maxErrorSquared, ex * ex + ey * ey + ez * ez);
+        }
+        float maxError = (float)std::sqrt(maxErrorSquared / (sumSquares / count));
+
+        double scalarMs = measure([&] { system.ComputeAccelerationsScalar(); });
+        double simdMs = measure([&] { system.ComputeAccelerations(); });
+        double interactions = (double)count * count;
+        std::cout << count << " bodies: scalar " << scalarMs << " ms, "
+            << NBodySystem::KernelName() << " " << simdMs << " ms ("
+            << interactions / (simdMs * 1e6) << " G interactions/s, "
+            << scalarMs / simdMs << "x), max relative error " << maxError << std::endl;
+
+        if (maxError > 5e-3f) {
+            std::cout << "ERROR::NBODY::KERNEL_MISMATCH" << std::endl;
+            result = -1;
+        }
+    }
+    return result;
+}
+
+// Exact acceleration of one body in double precision, for accuracy checks
+static glm::dvec3 directAcceleration(const NBodySystem& system, int body) {
+    const double eps2 = (double)system.softening * system.softening;
+    glm::dvec3 sum(0.0);
+    for (int j = 0; j < system.getCount(); ++j) {
+        double dx = (double)system.px[j] - system.px[body];
+        double dy = (double)system.py[j] - system.py[body];
+        double dz = (double)system.pz[j] - system.pz[body];
+        double inv = 1.0 / std::sqrt(dx * dx + dy * dy + dz * dz + eps2);
+        double s = system.mass[j] * inv * inv * inv;
+        sum += glm::dvec3(dx, dy, dz) * s;
+    }
+    return sum * (double)system.G;
+}
+
+int benchBarnesHut() {
+    const int SAMPLES = 64;
+
+    for (int count : { 10000, 100000, 1000000 }) {
+        NBodySystem system;
+        populate(system, count);
+        system.backend = NBodySystem::ForceBackend::BarnesHut;
+        BarnesHutTree& tree = system.tree;
+
+        double buildMs = measure([&] {
+            tree.Build(system.px.data(), system.py.data(), system.pz.data(), system.mass.data(), count);
+        });
+        double forceMs = measure([&] {
+            tree.ComputeAccelerations(system.G, system.softening, system.ax.data(), system.ay.data(), system.az.data());
+        });
+
+        // RMS error over evenly spaced bodies, relative to the RMS exact magnitude
+        double errorSquared = 0.0, magnitudeSquared = 0.0;
+        for (int sample = 0; sample < SAMPLES; ++sample) {
+            int body = (int)((long long)sample * count / SAMPLES);
+            glm::dvec3 exact = directAcceleration(system, body);
+            glm::dvec3 error = glm::dvec3(system.ax[body], system.ay[body], system.az[body]) - exact;
+            errorSquared += glm::dot(error, error);
+            magnitudeSquared += glm::dot(exact, exact);
+        }
+
+        std::cout << count << " bodies (theta " << tree.theta << "): build " << buildMs
+            << " ms, forces " << forceMs << " ms, " << tree.getNodeCount() << " nodes, RMS error "
+            << std::sqrt(errorSquared / magnitudeSquared) << std::endl;
+
+        if (count <= 10000) {
+            system.backend = NBodySystem::ForceBackend::DirectSum;
+            double directMs = measure([&] { system.ComputeAccelerations(); });
+            std::cout << "  direct sum (" << NBodySystem::KernelName() << "): " << directMs << " ms" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Microbenchmark: drawing thousands of orbit line loops one draw call each
+// (the old per-Orbit VAO path) against a single OrbitBatch multi-draw, at
+// the old fixed resolution and with screen-space levels of detail.
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "Framebuffer.h"
+#include "HeadlessContext.h"
+#include "OrbitBatch.h"
+#include "Shader.h"
+
+static const int FRAMES = 50;
+
+// Runs draw FRAMES times and prints the average CPU + GPU time per frame
+template <typename Fn>
+static void measure(const char* label, Fn draw) {
+    glFinish();
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; ++frame)
+        draw();
+    glFinish();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / FRAMES;
+    std::cout << label << ": " << ms << " ms/frame" << std::endl;
+}
+
+int benchOrbitBatch() {
+    HeadlessContext context;
+    if (!context.isValid())
+        return -1;
+    std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    // Small target so the numbers are dominated by submission, not fill
+    Framebuffer target(64, 64);
+    target.Bind();
+    Shader shader("orbit.vs", "orbit.fs");
+    shader.Use();
+    shader.setMat4("model", glm::mat4(1.0f));
+
+    for (int count : { 100, 1000, 5000 }) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Orbit> orbits;
+        orbits.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            OrbitalElements elements = OrbitalElements::Circular(100.0f + 50.0f * unit(rng), 0.0f);
+            elements.eccentricity = 0.3f * unit(rng);
+            elements.inclination = 0.3f * unit(rng);
+            orbits.emplace_back(elements);
+        }
+
+        // One VAO/VBO per orbit, as each Orbit used to own
+        const int level = OrbitBatch::DEFAULT_LEVEL;
+        std::vector<GLuint> VAOs(count), VBOs(count);
+        glGenVertexArrays(count, VAOs.data());
+        glGenBuffers(count, VBOs.data());
+        for (int i = 0; i < count; ++i) {
+            glBindVertexArray(VAOs[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, VBOs[i]);
+            glBufferData(GL_ARRAY_BUFFER, orbits[i].getVertices(level).size() * sizeof(float),
+                orbits[i].getVertices(level).data(), GL_STATIC_DRAW);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+        }
+        glBindVertexArray(0);
+
+        OrbitBatch batch;
+        for (const Orbit& orbit : orbits)
+            batch.Add(orbit, glm::vec3(0.6f));
+        batch.Draw();
+
+        std::cout << count << " orbits" << std::endl;
+        measure("  one draw per orbit", [&]() {
+            for (int i = 0; i < count; ++i) {
+                glBindVertexArray(VAOs[i]);
+                glDrawArrays(GL_LINE_LOOP, 0, orbits[i].getVertexCount(level));
+            }
+            glBindVertexArray(0);
+        });
+        measure("  OrbitBatch", [&]() { batch.Draw(); });
+
+        // 1080p at 45 degrees, seen from twice the orbits' distance
+        int fixedVertices = batch.getVertexCount();
+        batch.UpdateLevels(glm::vec3(0.0f, 200.0f, 500.0f), 1080.0f * 0.5f / std::tan(glm::radians(22.5f)));
+        batch.Draw();
+        std::cout << "  vertices: " << fixedVertices << " fixed, " << batch.getVertexCount() << " with LOD" << std::endl;
+        measure("  OrbitBatch, screen-space LOD", [&]() { batch.Draw(); });
+
+        glDeleteVertexArrays(count, VAOs.data());
+        glDeleteBuffers(count, VBOs.data());
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Microbenchmark: uniform setter throughput with driver lookups by name (the
+// original Shader behaviour), cached name lookups, and pre-resolved locations.
+// Runs on a surfaceless EGL context (Mesa llvmpipe works).
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Bench.h"
+#include "HeadlessContext.h"
+#include "Shader.h"
+
+static const int ITERATIONS = 1000000;
+
+// Runs fn ITERATIONS times and prints the average cost per call
+template <typename Fn>
+static void measure(const char* label, Fn fn) {
+    glFinish();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        fn(i);
+    glFinish();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    std::cout << label << ": " << ns << " ns/call" << std::endl;
+}
+
+int benchShaderUniforms() {
+    HeadlessContext context;
+    if (!context.isValid())
+        return -1;
+    std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    Shader shader("orbit.vs", "orbit.fs");
+    shader.Use();
+    glm::mat4 model(1.0f);
+
+    measure("glGetUniformLocation per call", [&](int i) {
+        model[3][0] = (float)i;
+        std::string name = "model";
+        glUniformMatrix4fv(glGetUniformLocation(shader.ID, name.c_str()), 1, GL_FALSE, &model[0][0]);
+    });
+
+    measure("Shader::setMat4(name), cached", [&](int i) {
+        model[3][0] = (float)i;
+        shader.setMat4("model", model);
+    });
+
+    const GLint modelLoc = shader.getUniformLocation("model");
+    measure("Shader::setMat4(location)", [&](int i) {
+        model[3][0] = (float)i;
+        shader.setMat4(modelLoc, model);
+    });
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Benchmark: streaming the finer mip levels of a large cooked map with
+// TextureStreamer. Cooks a synthetic 8192x4096 map, then zooms a body in
+// level by level (read + upload time per level), out again (eviction) and
+// under a tight budget, checking residency and GL errors each step. Last, two
+// bodies trade places under that budget: the one zooming in must get its level
+// even though the other still holds an extra level against flicker.
+#include <glad/glad.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "Bench.h"
+#include "CookedTexture.h"
+#include "HeadlessContext.h"
+#include "RgbImage.h"
+#include "TextureStreamer.h"
+
+static const int MAP_WIDTH = 8192;
+static const int MAP_HEIGHT = 4096;
+static const int TAIL_WIDTH = 1024;   // Resolution the texture array would hold
+
+// Smooth noise so BC1 sees realistic blocks rather than white noise
+static void fillSyntheticMap(RgbImage& image) {
+    image.width = MAP_WIDTH;
+    image.height = MAP_HEIGHT;
+    image.pixels.resize((size_t)MAP_WIDTH * MAP_HEIGHT * 3);
+    image.levelOffsets.assign(1, 0);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> jitter(-6, 6);
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            unsigned char* texel = &image.pixels[((size_t)y * MAP_WIDTH + x) * 3];
+            texel[0] = (unsigned char)(128 + 100 * std::sin(x * 0.013) * std::cos(y * 0.021) + jitter(rng));
+            texel[1] = (unsigned char)(90 + 60 * std::sin((x + y) * 0.007) + jitter(rng));
+            texel[2] = (unsigned char)(60 + 40 * std::cos(x * 0.003 - y * 0.011) + jitter(rng));
+        }
+    }
+    image.BuildMips();
+}
+
+// Runs Update (blocking) and reports its time, residency and GL errors
+static bool step(TextureStreamer& streamer, const char* label, float screenRadius) {
+    streamer.SetScreenRadius(0, screenRadius);
+    auto start = std::chrono::steady_clock::now();
+    streamer.Update();
+    glFinish();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    GLenum error = glGetError();
+    std::printf("  %-28s level %2d  %7.2f MB resident  %8.2f ms\n", label, streamer.getResidentLevel(0),
+        streamer.getResidentBytes() / (1024.0 * 1024.0), ms);
+    if (error != GL_NO_ERROR) {
+        std::cout << "ERROR::BENCH::GL_ERROR " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Non-blocking Updates, as a frame loop would run them, until stream reaches
+// level; false if it has not after a few seconds or over budget
+static bool settle(TextureStreamer& streamer, const char* label, int stream, int level) {
+    auto start = std::chrono::steady_clock::now();
+    double ms = 0.0;
+    while (streamer.getResidentLevel(stream) != level && ms < 5000.0) {
+        streamer.Update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::printf("  %-28s level %2d  %7.2f MB resident  %8.2f ms\n", label, streamer.getResidentLevel(stream),
+        streamer.getResidentBytes() / (1024.0 * 1024.0), ms);
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cout << "ERROR::BENCH::GL_ERROR " << error << std::endl;
+        return false;
+    }
+    if (streamer.getResidentLevel(stream) != level || streamer.getResidentBytes() > streamer.budget) {
+        std::cout << "ERROR::BENCH::STREAM_STALLED" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int benchTextureStreaming() {
+    HeadlessContext context;
+    if (!context.isValid())
+        return -1;
+    std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    std::string path = (std::filesystem::temp_directory_path() / "solarsystem_bench_map.stex").string();
+    {
+        RgbImage image;
+        fillSyntheticMap(image);
+        CookedTexture cooked;
+        cooked.Encode(image);
+        if (!cooked.Save(path))
+            return -1;
+    }
+
+    int result = 0;
+    {
+        TextureStreamer streamer;
+        streamer.blocking = true;
+        if (streamer.Add(path, TAIL_WIDTH, TAIL_WIDTH / 2) != 0) {
+            std::remove(path.c_str());
+            return -1;
+        }
+
+        // Screen radii whose wanted width (2 pi r) steps through the levels
+        bool ok = step(streamer, "tail only (r = 100 px)", 100.0f);
+        ok = ok && step(streamer, "2048 wide (r = 300 px)", 300.0f);
+        ok = ok && step(streamer, "4096 wide (r = 600 px)", 600.0f);
+        ok = ok && step(streamer, "8192 wide (r = 1200 px)", 1200.0f);
+        ok = ok && step(streamer, "zoom out to 2048 wide", 300.0f);
+        ok = ok && step(streamer, "off screen", 0.0f);
+        streamer.budget = (size_t)8 << 20;
+        ok = ok && step(streamer, "8192 wide, 8 MB budget", 1200.0f);
+        if (!ok)
+            result = -1;
+    }
+    if (result == 0) {
+        // Body 0 shrinks to 2048 wide but keeps its 4096 level (5.3 MB) while
+        // body 1 grows to 4096 wide: both targets fit 8 MB, all three levels do not
+        TextureStreamer streamer((size_t)8 << 20);
+        streamer.blocking = true;
+        bool ok = streamer.Add(path, TAIL_WIDTH, TAIL_WIDTH / 2) == 0
+            && streamer.Add(path, TAIL_WIDTH, TAIL_WIDTH / 2) == 1;
+        ok = ok && step(streamer, "two bodies, 4096 + tail", 600.0f);
+        streamer.blocking = false;
+        streamer.SetScreenRadius(0, 300.0f);
+        streamer.SetScreenRadius(1, 600.0f);
+        ok = ok && settle(streamer, "swap to 2048 + 4096", 1, 1);
+        if (!ok)
+            result = -1;
+    }
+    std::remove(path.c_str());
+    return result;
+}
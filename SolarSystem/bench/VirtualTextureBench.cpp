@@ -0,0 +1,201 @@
+// Benchmark: virtual texturing of a large tiled map with VirtualTextureCache.
+// Tiles a synthetic 8192x4096 map, then renders a sphere from further away
+// to close up: feedback pass + page reads + uploads per step, pages the frame
+// asked for against those resident, and the image against the same map
+// sampled from a complete mipmapped texture. A 16-page cache, too small for
+// the views, exercises LRU eviction and the fallback to coarser pages.
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "CookedTexture.h"
+#include "Framebuffer.h"
+#include "FrameUniforms.h"
+#include "HeadlessContext.h"
+#include "PlanetRenderer.h"
+#include "RgbImage.h"
+#include "Shader.h"
+#include "SphereMesh.h"
+#include "TextureArray.h"
+#include "TiledTexture.h"
+#include "VirtualTextureCache.h"
+
+static const int MAP_WIDTH = 8192;
+static const int MAP_HEIGHT = 4096;
+static const int VIEW_WIDTH = 1024;
+static const int VIEW_HEIGHT = 768;
+
+// Smooth noise so BC1 sees realistic blocks rather than white noise
+static void fillSyntheticMap(RgbImage& image) {
+    image.width = MAP_WIDTH;
+    image.height = MAP_HEIGHT;
+    image.pixels.resize((size_t)MAP_WIDTH * MAP_HEIGHT * 3);
+    image.levelOffsets.assign(1, 0);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> jitter(-6, 6);
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            unsigned char* texel = &image.pixels[((size_t)y * MAP_WIDTH + x) * 3];
+            texel[0] = (unsigned char)(128 + 100 * std::sin(x * 0.013) * std::cos(y * 0.021) + jitter(rng));
+            texel[1] = (unsigned char)(90 + 60 * std::sin((x + y) * 0.007) + jitter(rng));
+            texel[2] = (unsigned char)(60 + 40 * std::cos(x * 0.003 - y * 0.011) + jitter(rng));
+        }
+    }
+    image.BuildMips();
+}
+
+// Complete BC1 mip chain in one texture, what planet.fs samples for layer -1
+static GLuint createReference(const RgbImage& image) {
+    CookedTexture cooked;
+    cooked.Encode(image);
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    for (int level = 0; level < cooked.getLevelCount(); ++level) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, cooked.getLevelWidth(level),
+            cooked.getLevelHeight(level), 0, (GLsizei)cooked.levelSizes[level], cooked.getLevel(level));
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, cooked.getLevelCount() - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return texture;
+}
+
+struct View {
+    Framebuffer target{ VIEW_WIDTH, VIEW_HEIGHT };
+    FrameUniforms frame;
+    Shader shader{ "planet.vs", "planet.fs" };
+    PlanetRenderer renderer;
+    const SphereMesh* mesh = SphereMesh::Get(SphereMesh::LEVELS - 1);
+    glm::mat4 model = glm::rotate(glm::mat4(1.0f), 0.7f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Unit sphere at the origin seen from distance along +Z, slightly above the equator
+    void Look(float distance) {
+        glm::vec3 position(0.0f, distance * 0.3f, distance);
+        position = glm::normalize(position) * distance;
+        frame.SetView(glm::lookAt(position, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)), position);
+        frame.Upload();
+    }
+
+    void Draw(int layer, GLuint detailTexture, std::vector<unsigned char>& pixels) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        shader.Use();
+        renderer.Begin();
+        renderer.Submit(mesh, model, layer, detailTexture);
+        renderer.Flush();
+        target.ReadPixels(pixels);
+    }
+};
+
+// Feedback + update time and residency for one view; false on GL errors, on
+// requested pages missing from a cache that fits them, or a wrong image
+static bool step(View& view, VirtualTextureCache& cache, GLuint reference, const char* label, float distance) {
+    view.Look(distance);
+    view.renderer.Begin();
+    view.renderer.Submit(view.mesh, view.model, VirtualTextureCache::InstanceLayer(0), cache.getIndirection(0));
+    view.renderer.Upload();
+
+    auto start = std::chrono::steady_clock::now();
+    view.shader.Use();
+    cache.RenderFeedback(VIEW_WIDTH, VIEW_HEIGHT, [&] { view.renderer.Draw(); });
+    cache.Update();
+    glFinish();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<unsigned char> virtualPixels, referencePixels;
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, cache.getCacheTexture());
+    glActiveTexture(GL_TEXTURE0);
+    view.shader.Use();
+    view.shader.setFloat("pageCachePages", (float)cache.getCachePages());
+    view.Draw(VirtualTextureCache::InstanceLayer(0), cache.getIndirection(0), virtualPixels);
+    view.Draw(-1, reference, referencePixels);
+
+    double difference = 0.0;
+    for (size_t i = 0; i < virtualPixels.size(); ++i)
+        difference += std::abs((int)virtualPixels[i] - (int)referencePixels[i]);
+    difference /= virtualPixels.size();
+
+    std::printf("  %-26s %4d pages asked, %4d resident, cache %4d/%4d  %8.2f ms  mean error %.2f\n", label,
+        cache.getRequestedPages(), cache.getRequestedResident(), cache.getResidentPages(), cache.getCapacity(),
+        ms, difference);
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cout << "ERROR::BENCH::GL_ERROR " << error << std::endl;
+        return false;
+    }
+    bool fits = cache.getRequestedPages() < cache.getCapacity() / 2;
+    if (fits && (cache.getRequestedResident() != cache.getRequestedPages() || difference > 2.0)) {
+        std::cout << "ERROR::BENCH::VIRTUAL_TEXTURE_MISMATCH" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int benchVirtualTexture() {
+    HeadlessContext context;
+    if (!context.isValid())
+        return -1;
+    std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    std::string path = (std::filesystem::temp_directory_path() / "solarsystem_bench_map.vtex").string();
+    RgbImage image;
+    fillSyntheticMap(image);
+    auto start = std::chrono::steady_clock::now();
+    if (!TiledTexture::Write(path, image))
+        return -1;
+    double tileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("  tiled %dx%d in %.0f ms, %.1f MB on disk\n", MAP_WIDTH, MAP_HEIGHT, tileMs,
+        std::filesystem::file_size(path) / (1024.0 * 1024.0));
+
+    int result = 0;
+    {
+        View view;
+        view.target.Bind();
+        glViewport(0, 0, VIEW_WIDTH, VIEW_HEIGHT);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_CULL_FACE);
+        view.frame.SetViewport(VIEW_WIDTH, VIEW_HEIGHT);
+        view.shader.Use();
+        view.shader.setInt("ourTexture", 0);
+        view.shader.setInt("detailTexture", 1);
+        view.shader.setInt("pageCache", 2);
+        GLuint reference = createReference(image);
+
+        bool ok;
+        {
+            VirtualTextureCache cache;
+            cache.blocking = true;
+            ok = cache.Add(path) == 0;
+            ok = ok && step(view, cache, reference, "far (distance 8)", 8.0f);
+            ok = ok && step(view, cache, reference, "distance 3", 3.0f);
+            ok = ok && step(view, cache, reference, "distance 1.5", 1.5f);
+            ok = ok && step(view, cache, reference, "close up (distance 1.2)", 1.2f);
+            ok = ok && step(view, cache, reference, "back out (distance 8)", 8.0f);
+        }
+        if (ok) {
+            VirtualTextureCache small(4);
+            small.blocking = true;
+            ok = small.Add(path) == 0;
+            ok = ok && step(view, small, reference, "16-page cache, distance 3", 3.0f);
+            ok = ok && step(view, small, reference, "16-page cache, distance 1.2", 1.2f);
+        }
+        glDeleteTextures(1, &reference);
+        if (!ok)
+            result = -1;
+    }
+    SphereMesh::ReleaseAll();
+    std::remove(path.c_str());
+    return result;
+}
@@ -0,0 +1,26 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <EGL/egl.h>
+
+// OpenGL 3.3 core context without a window, created through EGL. Uses Mesa's
+// surfaceless platform when available (no display server or GPU needed with
+// llvmpipe) and falls back to the default EGL display. Rendering goes to FBOs.
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // True when the context is current and GL functions are loaded
+    bool isValid() const { return valid; }
+
+private:
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    bool valid = false;
+};
+
+#endif
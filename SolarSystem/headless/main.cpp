@@ -0,0 +1,158 @@
+// Headless renderer: draws the solar system into an offscreen framebuffer
+// through EGL (no window or display server) and writes every frame to disk.
+// Run from the SolarSystem directory so shaders and assets are found.
+//
+// Usage: solarsystem_headless [--frames N] [--width W] [--height H]
+//            [--start T] [--dt SECONDS] [--radius R] [--font PATH] [--out DIR]
+//            [--trace FILE.json] [--profile 1] [--gravity 1] [--theta T]
+//            [--asteroids N] [--gpu-asteroids 1] [--pack FILE.pak]
+//            [--texture-budget MB]
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "AssetPack.h"
+#include "Camera.h"
+#include "Framebuffer.h"
+#include "HeadlessContext.h"
+#include "Scene.h"
+
+struct HeadlessOptions {
+    int frames = 1;
+    int width = 1800;
+    int height = 1400;
+    float start = 0.0f;          // Simulation time of the first frame
+    float dt = 1.0f / 60.0f;     // Simulation time between frames
+    float radius = 300.0f;       // Camera distance from the Sun
+    std::string font;            // Text is skipped when empty
+    std::string out = "frames";
+    std::string trace;           // Chrome trace written after the last frame when set
+    bool profile = false;        // Draw the profiler overlay (needs --font)
+    bool gravity = false;        // N-body dynamics from --start onwards
+    float theta = 0.0f;          // Barnes-Hut opening angle, direct sum when 0
+    int asteroids = 0;           // Main-belt asteroids drawn as points
+    bool gpuAsteroids = false;   // Propagate them with transform feedback
+    std::string pack;            // Asset pack mounted before loading, loose files when empty
+    int textureBudget = 0;       // MB for streamed surface map levels, default when 0
+};
+
+// Parses command line flags; returns false on unknown flags or missing values
+static bool parseOptions(int argc, char** argv, HeadlessOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (!std::strcmp(flag, "--frames")) options.frames = std::atoi(value);
+        else if (!std::strcmp(flag, "--width")) options.width = std::atoi(value);
+        else if (!std::strcmp(flag, "--height")) options.height = std::atoi(value);
+        else if (!std::strcmp(flag, "--start")) options.start = (float)std::atof(value);
+        else if (!std::strcmp(flag, "--dt")) options.dt = (float)std::atof(value);
+        else if (!std::strcmp(flag, "--radius")) options.radius = (float)std::atof(value);
+        else if (!std::strcmp(flag, "--font")) options.font = value;
+        else if (!std::strcmp(flag, "--out")) options.out = value;
+        else if (!std::strcmp(flag, "--trace")) options.trace = value;
+        else if (!std::strcmp(flag, "--profile")) options.profile = std::atoi(value) != 0;
+        else if (!std::strcmp(flag, "--gravity")) options.gravity = std::atoi(value) != 0;
+        else if (!std::strcmp(flag, "--theta")) options.theta = (float)std::atof(value);
+        else if (!std::strcmp(flag, "--asteroids")) options.asteroids = std::atoi(value);
+        else if (!std::strcmp(flag, "--gpu-asteroids")) options.gpuAsteroids = std::atoi(value) != 0;
+        else if (!std::strcmp(flag, "--pack")) options.pack = value;
+        else if (!std::strcmp(flag, "--texture-budget")) options.textureBudget = std::atoi(value);
+        else {
+            std::cout << "Unknown option: " << flag << std::endl;
+            return false;
+        }
+    }
+    return options.frames > 0 && options.width > 0 && options.height > 0;
+}
+
+int main(int argc, char** argv) {
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options))
+        return -1;
+
+    HeadlessContext context;
+    if (!context.isValid())
+        return -1;
+    std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+
+    if (!options.pack.empty() && !AssetPack::Mount(options.pack)) {
+        std::cout << "Failed to open asset pack: " << options.pack << std::endl;
+        return -1;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(options.out, error);
+
+    int result = 0;
+    {
+        Framebuffer target(options.width, options.height);
+        target.Bind();
+
+        Scene scene(options.font, options.asteroids);
+        scene.FinishLoading();
+        scene.Resize(options.width, options.height);
+        Camera camera(options.radius, 0.0f, glm::radians(90.0f));
+        scene.showProfiler = options.profile;
+        Profiler& profiler = scene.getProfiler();
+        if (options.gpuAsteroids && scene.getAsteroids())
+            scene.getAsteroids()->SetGpuPropagation(true);
+        // Frames show every streamed level they ask for, independent of read speed
+        if (TextureStreamer* streamer = scene.getTextureStreamer()) {
+            streamer->blocking = true;
+            if (options.textureBudget > 0)
+                streamer->budget = (size_t)options.textureBudget << 20;
+        }
+        if (VirtualTextureCache* virtualTextures = scene.getVirtualTextures())
+            virtualTextures->blocking = true;
+        if (options.theta > 0.0f) {
+            NBodySystem& nbody = scene.getSimulation().getNBody();
+            nbody.backend = NBodySystem::ForceBackend::BarnesHut;
+            nbody.tree.theta = options.theta;
+        }
+        scene.getSimulation().Run(options.start);
+        if (options.gravity)
+            scene.getSimulation().SetDynamics(Simulation::Dynamics::Gravity);
+
+        for (int frame = 0; frame < options.frames; ++frame) {
+            profiler.BeginFrame();
+            if (frame > 0)
+                scene.getSimulation().Run(options.dt);
+            scene.Render(camera);
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame_%04d.ppm", frame);
+            bool saved;
+            {
+                ProfileScope scope(&profiler, "readback");
+                saved = target.SaveToFile(options.out + "/" + name);
+            }
+            profiler.EndFrame();
+            if (!saved) {
+                result = -1;
+                break;
+            }
+        }
+
+        if (TextureStreamer* streamer = scene.getTextureStreamer())
+            std::printf("streamed textures: %.1f MB resident\n", streamer->getResidentBytes() / (1024.0 * 1024.0));
+        if (VirtualTextureCache* virtualTextures = scene.getVirtualTextures()) {
+            std::printf("virtual textures: %d of %d pages resident, %d of %d requested\n",
+                virtualTextures->getResidentPages(), virtualTextures->getCapacity(),
+                virtualTextures->getRequestedResident(), virtualTextures->getRequestedPages());
+        }
+        if (!options.trace.empty() && !profiler.WriteChromeTrace(options.trace))
+            result = -1;
+    }
+    return result;
+}
@@ -0,0 +1,37 @@
+#version 330 core
+// Keplerian propagation for transform feedback: one vertex per orbit in,
+// its position at the current time out (see KeplerFeedback)
+layout (location = 0) in vec4 motion;       // M0, n high, n low (turns, turns/s), e
+layout (location = 1) in vec3 majorAxis;    // a * P
+layout (location = 2) in vec3 minorAxis;    // b * Q
+
+// Simulation time split so motion.y * timeHigh is exact
+uniform float timeHigh;
+uniform float timeLow;
+
+out vec3 position;
+
+const float TWO_PI = 6.28318530718;
+
+void main()
+{
+    float e = motion.w;
+
+    // Mean anomaly with the whole turns of each partial product removed
+    float turns = motion.x + fract(motion.y * timeHigh) + fract(motion.z * timeHigh)
+        + (motion.y + motion.z) * timeLow;
+    float M = TWO_PI * (fract(turns + 0.5) - 0.5);
+
+    // Second-order start and Halley steps, as many as KeplerIterations gives
+    // (e is already clamped to MAX_ECCENTRICITY by KeplerBatch)
+    float E = M + e * sin(M) * (1.0 + e * cos(M));
+    int iterations = e <= 0.3 ? 1 : (e <= 0.85 ? 2 : (e <= 0.98 ? 3 : 4));
+    for (int k = 0; k < iterations; ++k) {
+        float s = sin(E);
+        float f = E - e * s - M;
+        float f1 = 1.0 - e * cos(E);
+        E -= f * f1 / max(f1 * f1 - 0.5 * f * e * s, 0.5 * f1 * f1);
+    }
+
+    position = majorAxis * (cos(E) - e) + minorAxis * sin(E);
+}
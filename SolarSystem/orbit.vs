@@ -1,11 +1,19 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 cameraPosition;
+    vec4 viewport;
+};
+
+out vec3 orbitColor;
 
 void main()
 {
+    orbitColor = aColor;
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
@@ -3,10 +3,48 @@
 out vec4 color;
 
 in vec2 texCoord;
+flat in float textureLayer;
 
-uniform sampler2D ourTexture;
+uniform sampler2DArray ourTexture;
+uniform sampler2D detailTexture;   // Streamed surface map (layer -1) or virtual texture indirection (layer <= -2)
+uniform sampler2D pageCache;       // Physical pages of virtual textures
+uniform float pageCachePages;      // Slots per side of pageCache
+
+// Must match TiledTexture
+const float PAGE_SIZE = 128.0;
+const float BORDER = 4.0;
+const float PADDED_SIZE = 136.0;
+
+// Mip level of the virtual texture; planet_feedback.fs requests pages with the same rule
+float virtualLevel(vec2 pages, vec2 uvdx, vec2 uvdy)
+{
+    vec2 size = pages * PAGE_SIZE;
+    vec2 dx = uvdx * size, dy = uvdy * size;
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+    return clamp(floor(lod + 0.5), 0.0, log2(max(pages.x, pages.y)));
+}
+
+// The indirection entry names the cache slot of the page, or of its finest
+// resident ancestor, and that page's level
+vec4 sampleVirtual(vec2 uv, vec2 uvdx, vec2 uvdy)
+{
+    vec2 pages = vec2(textureSize(detailTexture, 0));
+    uv = vec2(fract(uv.x), clamp(uv.y, 0.0, 0.99999));
+    vec4 entry = floor(textureLod(detailTexture, uv, virtualLevel(pages, uvdx, uvdy)) * 255.0 + 0.5);
+    vec2 texel = uv * pages * PAGE_SIZE / exp2(entry.b);
+    vec2 inPage = texel - floor(texel / PAGE_SIZE) * PAGE_SIZE;
+    vec2 physical = entry.rg * PADDED_SIZE + BORDER + inPage;
+    return textureLod(pageCache, physical / (pageCachePages * PADDED_SIZE), 0.0);
+}
 
 void main()
 {
-    color = texture(ourTexture, texCoord);
-}
\ No newline at end of file
+    // Derivatives outside the branches, the map wraps inside sampleVirtual
+    vec2 uvdx = dFdx(texCoord), uvdy = dFdy(texCoord);
+    if (textureLayer < -1.5)
+        color = sampleVirtual(texCoord, uvdx, uvdy);
+    else if (textureLayer < 0.0)
+        color = texture(detailTexture, texCoord);
+    else
+        color = texture(ourTexture, vec3(texCoord, textureLayer));
+}
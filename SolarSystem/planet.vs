@@ -3,14 +3,23 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 aTexCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Per-instance attributes (divisor 1)
+layout (location = 2) in mat4 instanceModel;
+layout (location = 6) in float instanceTextureLayer;
+
+layout (std140) uniform FrameUniforms {
+    mat4 projection;
+    mat4 view;
+    vec4 cameraPosition;
+    vec4 viewport;
+};
 
 out vec2 texCoord;
+flat out float textureLayer;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    gl_Position = projection * view * instanceModel * vec4(position, 1.0);
     texCoord = aTexCoord;
+    textureLayer = instanceTextureLayer;
 }
@@ -0,0 +1,34 @@
+#version 330 core
+
+// Virtual texture feedback: the page each pixel of a virtually textured body
+// samples, read back by VirtualTextureCache. Other bodies write 0 ("no page").
+
+out vec4 color;
+
+in vec2 texCoord;
+flat in float textureLayer;
+
+uniform sampler2D detailTexture;   // Indirection texture, sized one texel per level 0 page
+uniform float feedbackBias;        // -log2 of the feedback target's downscale
+
+const float PAGE_SIZE = 128.0;
+
+void main()
+{
+    vec2 pages = vec2(textureSize(detailTexture, 0));
+    vec2 size = pages * PAGE_SIZE;
+    vec2 dx = dFdx(texCoord) * size, dy = dFdy(texCoord) * size;
+    if (textureLayer > -1.5) {
+        color = vec4(0.0);
+        return;
+    }
+
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy))) + feedbackBias;
+    float level = clamp(floor(lod + 0.5), 0.0, log2(max(pages.x, pages.y)));
+
+    vec2 uv = vec2(fract(texCoord.x), clamp(texCoord.y, 0.0, 0.99999));
+    vec2 page = floor(uv * size / exp2(level) / PAGE_SIZE);
+    page = min(page, max(floor(pages / exp2(level)), 1.0) - 1.0);
+    float map = -2.0 - textureLayer;
+    color = vec4(page, level, map + 1.0) / 255.0;
+}
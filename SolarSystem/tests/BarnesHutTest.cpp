@@ -0,0 +1,80 @@
+// Tests: Barnes-Hut accelerations against a double precision direct sum for a
+// clustered random system, exact-ish at theta 0 and within a few percent at
+// the default opening angle.
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "BarnesHut.h"
+#include "Tests.h"
+
+int testBarnesHut() {
+    int failures = 0;
+    const int count = 3000;
+    const float G = 1.0f, softening = 0.05f;
+
+    // Two Gaussian clusters, so the tree is uneven
+    std::mt19937 rng(5);
+    std::normal_distribution<float> spread(0.0f, 1.0f);
+    std::uniform_real_distribution<float> massRange(0.5f, 2.0f);
+    std::vector<float> px(count), py(count), pz(count), mass(count);
+    for (int i = 0; i < count; ++i) {
+        float offset = i % 3 == 0 ? 8.0f : 0.0f;
+        px[i] = spread(rng) + offset;
+        py[i] = 0.3f * spread(rng);
+        pz[i] = spread(rng) - offset;
+        mass[i] = massRange(rng);
+    }
+
+    std::vector<double> dx(count), dy(count), dz(count);
+    for (int i = 0; i < count; ++i) {
+        double ax = 0.0, ay = 0.0, az = 0.0;
+        for (int j = 0; j < count; ++j) {
+            double rx = px[j] - px[i], ry = py[j] - py[i], rz = pz[j] - pz[i];
+            double d2 = rx * rx + ry * ry + rz * rz + (double)softening * softening;
+            double inv = 1.0 / std::sqrt(d2);
+            double s = G * mass[j] * inv * inv * inv;
+            ax += s * rx;
+            ay += s * ry;
+            az += s * rz;
+        }
+        dx[i] = ax;
+        dy[i] = ay;
+        dz[i] = az;
+    }
+
+    // Worst and RMS relative error per body
+    for (float theta : { 0.0f, 0.5f }) {
+        BarnesHutTree tree;
+        tree.theta = theta;
+        tree.Build(px.data(), py.data(), pz.data(), mass.data(), count);
+        CHECK(tree.getBodyCount() == count);
+        std::vector<float> ax(count), ay(count), az(count);
+        tree.ComputeAccelerations(G, softening, ax.data(), ay.data(), az.data());
+
+        double worst = 0.0, sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            double ex = ax[i] - dx[i], ey = ay[i] - dy[i], ez = az[i] - dz[i];
+            double relative = std::sqrt((ex * ex + ey * ey + ez * ez) / (dx[i] * dx[i] + dy[i] * dy[i] + dz[i] * dz[i]));
+            worst = std::max(worst, relative);
+            sum += relative * relative;
+        }
+        double rms = std::sqrt(sum / count);
+        std::cout << "  theta " << theta << ": rms error " << rms << ", worst " << worst << std::endl;
+        if (theta == 0.0f) {
+            CHECK(worst < 1e-3);
+        }
+        else {
+            CHECK(rms < 0.01);
+            CHECK(worst < 0.05);
+        }
+    }
+
+    // Rebuilding with fewer bodies reuses the tree
+    BarnesHutTree tree;
+    tree.Build(px.data(), py.data(), pz.data(), mass.data(), count);
+    tree.Build(px.data(), py.data(), pz.data(), mass.data(), 10);
+    CHECK(tree.getBodyCount() == 10);
+    return failures;
+}
@@ -0,0 +1,102 @@
+// Tests: the lock-free TripleBuffer between a writer and a reader thread, and
+// JobSystem::ParallelFor coverage on the shared scheduler.
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Tests.h"
+#include "TripleBuffer.h"
+
+// Snapshot whose fields must agree if it was published whole
+struct Snapshot {
+    int sequence = -1;
+    int values[64] = {};
+};
+
+int testTripleBuffer() {
+    int failures = 0;
+
+    TripleBuffer<int> buffer;
+    CHECK(!buffer.Update());
+    buffer.Back() = 1;
+    buffer.Publish();
+    CHECK(buffer.Update() && buffer.Front() == 1);
+    CHECK(!buffer.Update() && buffer.Front() == 1);
+    buffer.Back() = 2;
+    buffer.Publish();
+    buffer.Back() = 3;
+    buffer.Publish();
+    CHECK(buffer.Update() && buffer.Front() == 3);   // 2 was superseded
+
+    // Reader never sees a torn snapshot or one older than the last it saw
+    const int published = 200000;
+    TripleBuffer<Snapshot> snapshots;
+    std::thread writer([&] {
+        for (int sequence = 0; sequence < published; ++sequence) {
+            Snapshot& back = snapshots.Back();
+            back.sequence = sequence;
+            for (int& value : back.values)
+                value = sequence;
+            snapshots.Publish();
+        }
+    });
+    int last = -1, torn = 0, backwards = 0;
+    while (last < published - 1) {
+        if (!snapshots.Update())
+            continue;
+        const Snapshot& front = snapshots.Front();
+        for (int value : front.values)
+            torn += value != front.sequence;
+        backwards += front.sequence <= last;
+        last = front.sequence;
+    }
+    writer.join();
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    return failures;
+}
+
+int testJobSystem() {
+    int failures = 0;
+    JobSystem& jobs = JobSystem::Get();
+
+    // Every index once, for grains below, at and above the range size
+    for (int grain : { 1, 7, 1000, 100000, 2000000 }) {
+        const int begin = 3, end = 1000003;
+        std::vector<std::atomic<int>> visits(end);
+        std::atomic<int> calls{ 0 }, badRanges{ 0 };
+        jobs.ParallelFor(begin, end, grain, [&](int rangeBegin, int rangeEnd) {
+            ++calls;
+            if (rangeBegin < begin || rangeEnd > end || rangeBegin >= rangeEnd)
+                ++badRanges;
+            for (int i = rangeBegin; i < rangeEnd; ++i)
+                visits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        int wrong = 0;
+        for (int i = 0; i < end; ++i)
+            wrong += visits[i].load() != (i >= begin ? 1 : 0);
+        CHECK(wrong == 0);
+        CHECK(badRanges == 0);
+        if (grain >= end - begin)
+            CHECK(calls == 1);
+    }
+
+    // Empty ranges call nothing; nested loops from inside jobs finish
+    bool called = false;
+    jobs.ParallelFor(5, 5, 1, [&](int, int) { called = true; });
+    CHECK(!called);
+    std::atomic<long long> sum{ 0 };
+    jobs.ParallelFor(0, 64, 1, [&](int outerBegin, int outerEnd) {
+        for (int outer = outerBegin; outer < outerEnd; ++outer) {
+            JobSystem::Get().ParallelFor(0, 1000, 10, [&](int innerBegin, int innerEnd) {
+                long long partial = 0;
+                for (int inner = innerBegin; inner < innerEnd; ++inner)
+                    partial += inner;
+                sum += partial;
+            });
+        }
+    });
+    CHECK(sum == 64LL * 999 * 1000 / 2);
+    return failures;
+}
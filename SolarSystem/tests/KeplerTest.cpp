@@ -0,0 +1,81 @@
+// Tests: Kepler's equation in float against double precision Newton, across
+// the mean anomaly range (dense near periapsis, where high e is hardest) and
+// eccentricities up to MAX_ECCENTRICITY.
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <math.h>
+#include <vector>
+
+#include "Kepler.h"
+#include "Tests.h"
+
+static double solveExact(double M, double e) {
+    double E = e > 0.8 ? (M < 0.0 ? -M_PI : M_PI) : M;
+    for (int k = 0; k < 100; ++k)
+        E -= (E - e * std::sin(E) - M) / (1.0 - e * std::cos(E));
+    return E;
+}
+
+// Uniform over [-pi, pi) plus +-10^-8..1 on a log scale
+static std::vector<float> meanAnomalies() {
+    std::vector<float> samples;
+    for (int i = 0; i < 4000; ++i)
+        samples.push_back((float)(M_PI * (i - 2000) / 2000.0));
+    for (int i = 0; i <= 800; ++i) {
+        float M = (float)std::pow(10.0, -8.0 + 8.0 * i / 800.0);
+        samples.push_back(M);
+        samples.push_back(-M);
+    }
+    return samples;
+}
+
+int testKepler() {
+    int failures = 0;
+    const std::vector<float> samples = meanAnomalies();
+
+    for (float e : { 0.0f, 0.1f, 0.3f, 0.6f, 0.85f, 0.9f, 0.95f, 0.975f, 0.98f, 0.99f, MAX_ECCENTRICITY }) {
+        double worst = 0.0;
+        for (float M : samples)
+            worst = std::max(worst, std::fabs(SolveKepler(M, e) - solveExact(M, e)));
+        if (worst > 1e-5)
+            std::cout << "  e = " << e << ": worst error " << worst << " rad" << std::endl;
+        CHECK(worst <= 1e-5);
+    }
+
+    // Beyond the verified range the solver clamps instead of diverging
+    for (float M : samples) {
+        float E = SolveKepler(M, 0.9999f);
+        CHECK(std::isfinite(E) && E == SolveKepler(M, MAX_ECCENTRICITY));
+    }
+
+    // The batch (SIMD, several blocks, a partial last one) matches the scalar path
+    KeplerBatch batch;
+    std::vector<OrbitalElements> orbits;
+    for (int i = 0; i < 45; ++i) {
+        OrbitalElements orbit;
+        orbit.semiMajorAxis = 50.0f + i;
+        orbit.eccentricity = i == 44 ? 0.9999f : MAX_ECCENTRICITY * i / 43.0f;
+        orbit.inclination = 0.05f * i;
+        orbit.ascendingNode = 0.3f * i;
+        orbit.periapsis = 0.7f * i;
+        orbit.meanAnomaly = 0.11f * i - 2.0f;
+        orbit.meanMotion = 0.01f + 0.002f * i;
+        CHECK(batch.Add(orbit) == i);
+        orbit.eccentricity = std::min(orbit.eccentricity, MAX_ECCENTRICITY);
+        orbits.push_back(orbit);
+    }
+    CHECK(batch.getCount() == 45);
+    for (double t : { 0.0, 17.5, 12345.0 }) {
+        std::vector<float> x(45), y(45), z(45);
+        batch.Propagate(t, x.data(), y.data(), z.data());
+        for (int i = 0; i < 45; ++i) {
+            const OrbitalElements& orbit = orbits[i];
+            glm::vec3 exact = orbit.PositionAtAnomaly((float)solveExact(orbit.MeanAnomalyAt(t), orbit.eccentricity));
+            glm::vec3 error = glm::vec3(x[i], y[i], z[i]) - exact;
+            CHECK(std::sqrt(glm::dot(error, error)) <= 1e-4f * orbit.semiMajorAxis);
+        }
+    }
+    return failures;
+}
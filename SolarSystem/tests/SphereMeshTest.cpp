@@ -0,0 +1,42 @@
+// Tests: SphereMesh::SelectLevel picks finer levels as a body grows on screen
+// and only drops one once the body has shrunk by more than the hysteresis.
+#include <cmath>
+
+#include "SphereMesh.h"
+#include "Tests.h"
+
+int testSphereMesh() {
+    int failures = 0;
+    CHECK(SphereMesh::SelectLevel(0.0f, 0) == 0);
+    CHECK(SphereMesh::SelectLevel(0.0f, SphereMesh::LEVELS - 1) == 0);
+    CHECK(SphereMesh::SelectLevel(1e9f, 0) == SphereMesh::LEVELS - 1);
+
+    // Growing: levels never go back and reach the finest
+    int level = 0;
+    float lastGrowth[SphereMesh::LEVELS] = {};
+    for (float radius = 1.0f; radius < 1e5f; radius *= 1.01f) {
+        int next = SphereMesh::SelectLevel(radius, level);
+        CHECK(next >= level && next < SphereMesh::LEVELS);
+        for (int l = level + 1; l <= next; ++l)
+            lastGrowth[l] = radius;
+        level = next;
+    }
+    CHECK(level == SphereMesh::LEVELS - 1);
+
+    for (int l = 1; l < SphereMesh::LEVELS; ++l) {
+        float radius = lastGrowth[l];
+        CHECK(radius > 0.0f && SphereMesh::SelectLevel(radius, 0) >= l);
+        // Shrinking by less than sqrt(2) keeps the level, by more drops it
+        CHECK(SphereMesh::SelectLevel(radius / 1.3f, l) == l);
+        CHECK(SphereMesh::SelectLevel(radius / 1.5f, l) < l);
+        // A body wobbling around the switch radius does not flicker
+        int current = SphereMesh::SelectLevel(radius, l - 1);
+        for (int frame = 0; frame < 100; ++frame) {
+            float wobble = radius * (frame % 2 ? 1.02f : 1.0f / 1.1f);
+            int next = SphereMesh::SelectLevel(wobble, current);
+            CHECK(next == current);
+            current = next;
+        }
+    }
+    return failures;
+}
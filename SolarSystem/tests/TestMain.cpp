@@ -0,0 +1,47 @@
+// solarsystem_tests: runs every test, or only those named on the command line.
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "Tests.h"
+
+struct TestEntry {
+    const char* name;
+    int (*run)();
+};
+
+static const TestEntry tests[] = {
+    { "kepler", testKepler },
+    { "bc1", testBc1 },
+    { "stex", testCookedTexture },
+    { "pak", testAssetPack },
+    { "vtex", testTiledTexture },
+    { "triplebuffer", testTripleBuffer },
+    { "jobs", testJobSystem },
+    { "barneshut", testBarnesHut },
+    { "spheremesh", testSphereMesh },
+};
+
+std::string testPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+int main(int argc, char** argv) {
+    int result = 0;
+    for (const TestEntry& test : tests) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected |= std::strcmp(argv[i], test.name) == 0;
+        if (!selected)
+            continue;
+
+        int failures = test.run();
+        std::cout << (failures ? "FAILED " : "passed ") << test.name;
+        if (failures)
+            std::cout << " (" << failures << " checks)";
+        std::cout << std::endl;
+        if (failures)
+            result = 1;
+    }
+    return result;
+}
@@ -0,0 +1,50 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <iostream>
+#include <string>
+
+// Unit tests linked into solarsystem_tests; each returns the number of failed
+// checks. They need no GL context and run from the SolarSystem directory.
+
+// CHECK counts into a local "int failures" and reports the failing expression
+#define CHECK(condition)                                                                         \
+    do {                                                                                         \
+        if (!(condition)) {                                                                      \
+            std::cout << "ERROR::TEST::CHECK_FAILED " << __FILE__ << ":" << __LINE__ << ": "     \
+                      << #condition << std::endl;                                                \
+            ++failures;                                                                          \
+        }                                                                                        \
+    } while (0)
+
+// File in the system temporary directory, removed by the test that wrote it
+std::string testPath(const char* name);
+
+// SolveKepler and KeplerBatch against a double precision solution, up to MAX_ECCENTRICITY
+int testKepler();
+
+// BC1 sizes, solid blocks and encode/decode round trips
+int testBc1();
+
+// .stex save and load, partial level ranges and malformed files
+int testCookedTexture();
+
+// .pak write, lookup, verification and corrupt files
+int testAssetPack();
+
+// .vtex tiling, page reads and malformed files
+int testTiledTexture();
+
+// TripleBuffer publish/update order and snapshots across threads
+int testTripleBuffer();
+
+// JobSystem::ParallelFor covers every index exactly once
+int testJobSystem();
+
+// BarnesHutTree accelerations against the direct sum
+int testBarnesHut();
+
+// SphereMesh::SelectLevel range and hysteresis
+int testSphereMesh();
+
+#endif
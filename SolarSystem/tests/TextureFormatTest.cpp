@@ -0,0 +1,273 @@
+// Tests: BC1 compression and the cooked asset formats (.stex, .pak, .vtex),
+// written to temporary files, read back, and rejected when damaged.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+#include "AssetPack.h"
+#include "Bc1.h"
+#include "CookedTexture.h"
+#include "RgbImage.h"
+#include "Tests.h"
+#include "TiledTexture.h"
+
+// Smooth gradients, what surface maps look like to BC1
+static void fillGradient(RgbImage& image, int width, int height) {
+    image.width = width;
+    image.height = height;
+    image.pixels.resize((size_t)width * height * 3);
+    image.levelOffsets.assign(1, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char* texel = &image.pixels[((size_t)y * width + x) * 3];
+            texel[0] = (unsigned char)(128 + 100 * std::sin(x * 0.05) * std::cos(y * 0.07));
+            texel[1] = (unsigned char)(128 + 90 * std::sin(x * 0.03 + y * 0.01));
+            texel[2] = (unsigned char)(128 + 90 * std::cos(y * 0.04));
+        }
+    }
+}
+
+static double rmsError(const unsigned char* a, const unsigned char* b, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i)
+        sum += (double)(a[i] - b[i]) * (a[i] - b[i]);
+    return std::sqrt(sum / count);
+}
+
+static std::vector<unsigned char> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+}
+
+int testBc1() {
+    int failures = 0;
+    CHECK(bc1::CompressedSize(4, 4) == 8);
+    CHECK(bc1::CompressedSize(1, 1) == 8);
+    CHECK(bc1::CompressedSize(5, 5) == 32);
+    CHECK(bc1::CompressedSize(2048, 1024) == 2048 * 1024 / 2);
+
+    // RGB565-exact colors survive unchanged, from SolidBlock and from Encode
+    unsigned char block[8], decoded[4 * 4 * 3];
+    bc1::SolidBlock(255, 0, 0, block);
+    bc1::Decode(block, 4, 4, decoded);
+    for (int i = 0; i < 16; ++i)
+        CHECK(decoded[i * 3] == 255 && decoded[i * 3 + 1] == 0 && decoded[i * 3 + 2] == 0);
+
+    std::vector<unsigned char> solid(16 * 16 * 3);
+    for (size_t i = 0; i < solid.size(); i += 3) {
+        solid[i] = 0;
+        solid[i + 1] = 255;
+        solid[i + 2] = 255;
+    }
+    std::vector<unsigned char> blocks(bc1::CompressedSize(16, 16)), roundTrip(solid.size());
+    bc1::Encode(solid.data(), 16, 16, blocks.data());
+    bc1::Decode(blocks.data(), 16, 16, roundTrip.data());
+    CHECK(roundTrip == solid);
+
+    // Gradients stay close, including partial blocks at the edges
+    for (int size : { 64, 13 }) {
+        RgbImage image;
+        fillGradient(image, size, size / 2 + 1);
+        blocks.assign(bc1::CompressedSize(image.width, image.height), 0);
+        roundTrip.assign(image.pixels.size(), 0);
+        bc1::Encode(image.pixels.data(), image.width, image.height, blocks.data());
+        bc1::Decode(blocks.data(), image.width, image.height, roundTrip.data());
+        CHECK(rmsError(image.pixels.data(), roundTrip.data(), image.pixels.size()) < 6.0);
+    }
+    return failures;
+}
+
+int testCookedTexture() {
+    int failures = 0;
+    std::string path = testPath("solarsystem_test.stex");
+    std::string badPath = testPath("solarsystem_test_bad.stex");
+
+    RgbImage image;
+    fillGradient(image, 64, 32);
+    image.BuildMips();
+    CookedTexture cooked;
+    cooked.Encode(image);
+    CHECK(cooked.getLevelCount() == 7);
+    CHECK(cooked.Save(path));
+
+    int width = 0, height = 0;
+    CHECK(CookedTexture::ReadHeader(path, width, height) && width == 64 && height == 32);
+    CHECK(CookedTexture::FindLevel(64, 32, 16, 8) == 2);
+    CHECK(CookedTexture::FindLevel(64, 32, 16, 16) == -1);
+
+    CookedTexture loaded;
+    CHECK(loaded.Load(path));
+    CHECK(loaded.getLevelCount() == 7 && loaded.firstLevel == 0 && loaded.lastLevel == 6);
+    for (int level = 0; level < loaded.getLevelCount() && level < cooked.getLevelCount(); ++level) {
+        CHECK(loaded.levelSizes[level] == cooked.levelSizes[level]);
+        CHECK(!std::memcmp(loaded.getLevel(level), cooked.getLevel(level), cooked.levelSizes[level]));
+    }
+
+    // Only the requested levels are read
+    CookedTexture partial;
+    CHECK(partial.Load(path, 2, 4));
+    CHECK(partial.firstLevel == 2 && partial.lastLevel == 4);
+    CHECK(partial.getSize() == cooked.levelSizes[2] + cooked.levelSizes[3] + cooked.levelSizes[4]);
+    for (int level = 2; level <= 4; ++level)
+        CHECK(!std::memcmp(partial.getLevel(level), cooked.getLevel(level), cooked.levelSizes[level]));
+    CHECK(!partial.Load(path, 3, 2));
+    CHECK(!partial.Load(path, 0, 7));
+
+    // Header: magic, version, format, width, height, levelCount; then { offset, size } per level
+    const std::vector<unsigned char> file = readFile(path);
+    const size_t table = 24;
+    auto rejects = [&](std::vector<unsigned char> bytes) {
+        writeFile(badPath, bytes);
+        CookedTexture bad;
+        return !bad.Load(badPath);
+    };
+    std::vector<unsigned char> bytes = file;
+    bytes.resize(file.size() - 1);
+    CHECK(rejects(bytes));   // Truncated last level
+    bytes = file;
+    bytes[0] = 'X';
+    CHECK(rejects(bytes));   // Magic
+    bytes = file;
+    uint32_t levelCount = 5;
+    std::memcpy(&bytes[20], &levelCount, 4);
+    CHECK(rejects(bytes));   // Partial mip chain
+    bytes = file;
+    uint64_t offset;
+    std::memcpy(&offset, &bytes[table], 8);
+    std::memcpy(&bytes[table + 16], &offset, 8);
+    CHECK(rejects(bytes));   // Level 1 overlapping level 0
+    bytes = file;
+    offset = 8;
+    std::memcpy(&bytes[table], &offset, 8);
+    CHECK(rejects(bytes));   // Level 0 inside the header
+
+    std::remove(path.c_str());
+    std::remove(badPath.c_str());
+    return failures;
+}
+
+int testAssetPack() {
+    int failures = 0;
+    std::string first = testPath("solarsystem_test_a.txt");
+    std::string second = testPath("solarsystem_test_b.bin");
+    std::string path = testPath("solarsystem_test.pak");
+    std::string badPath = testPath("solarsystem_test_bad.pak");
+
+    const std::string text = "#version 330 core\n";
+    writeFile(first, std::vector<unsigned char>(text.begin(), text.end()));
+    std::vector<unsigned char> binary(10000);
+    for (size_t i = 0; i < binary.size(); ++i)
+        binary[i] = (unsigned char)(i * 31 + 7);
+    writeFile(second, binary);
+
+    CHECK(AssetPack::Write(path, { second, first, first }));
+    {
+        AssetPack pack(path);
+        CHECK(pack.isValid());
+        CHECK(pack.getEntryCount() == 2);
+        CHECK(pack.Verify());
+        AssetPack::Asset asset;
+        CHECK(pack.Find(first, asset) && asset.size == text.size() && !std::memcmp(asset.data, text.data(), text.size()));
+        CHECK(pack.Find(second, asset) && asset.size == binary.size()
+            && !std::memcmp(asset.data, binary.data(), binary.size()));
+        CHECK(asset.hash == AssetPack::Hash(binary.data(), binary.size()));
+        CHECK((uintptr_t)asset.data % AssetPack::ALIGNMENT == 0);
+        CHECK(!pack.Find("missing.vs", asset));
+    }
+    CHECK(!AssetPack::Write(badPath, { testPath("solarsystem_test_missing") }));
+
+    // A flipped payload byte fails verification; a cut name table fails to open
+    std::vector<unsigned char> bytes = readFile(path);
+    auto payload = std::search(bytes.begin(), bytes.end(), binary.begin(), binary.begin() + 64);
+    CHECK(payload != bytes.end());
+    if (payload != bytes.end()) {
+        payload[100] ^= 1;
+        writeFile(badPath, bytes);
+        AssetPack pack(badPath);
+        CHECK(pack.isValid() && !pack.Verify());
+    }
+    bytes = readFile(path);
+    bytes.pop_back();
+    writeFile(badPath, bytes);
+    CHECK(!AssetPack(badPath).isValid());
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+    std::remove(path.c_str());
+    std::remove(badPath.c_str());
+    return failures;
+}
+
+int testTiledTexture() {
+    int failures = 0;
+    std::string path = testPath("solarsystem_test.vtex");
+    std::string badPath = testPath("solarsystem_test_bad.vtex");
+
+    RgbImage odd;
+    fillGradient(odd, 200, 128);
+    odd.BuildMips();
+    CHECK(!TiledTexture::Write(path, odd));   // Not a power of two
+
+    RgbImage image;
+    fillGradient(image, 512, 256);
+    image.BuildMips();
+    CHECK(TiledTexture::Write(path, image));
+
+    TiledTexture tiled;
+    CHECK(tiled.Open(path));
+    CHECK(tiled.width == 512 && tiled.height == 256 && tiled.levelCount == 3);
+    CHECK(tiled.getPagesX(0) == 4 && tiled.getPagesY(0) == 2);
+    CHECK(tiled.getPagesX(2) == 1 && tiled.getPagesY(2) == 1);
+    CHECK(tiled.pageBytes == bc1::CompressedSize(TiledTexture::PADDED_SIZE, TiledTexture::PADDED_SIZE));
+
+    // Every page's interior decodes to its part of the level, its apron to the
+    // neighbouring texels (wrapping in x, clamped in y)
+    const int padded = TiledTexture::PADDED_SIZE, border = TiledTexture::BORDER;
+    std::vector<unsigned char> page(tiled.pageBytes), texels((size_t)padded * padded * 3);
+    for (int level = 0; level < tiled.levelCount; ++level) {
+        int levelWidth = image.getLevelWidth(level), levelHeight = image.getLevelHeight(level);
+        const unsigned char* source = image.getLevel(level);
+        for (int py = 0; py < tiled.getPagesY(level); ++py) {
+            for (int px = 0; px < tiled.getPagesX(level); ++px) {
+                CHECK(tiled.ReadPage(level, px, py, page.data()));
+                bc1::Decode(page.data(), padded, padded, texels.data());
+                double sum = 0.0;
+                for (int y = 0; y < padded; ++y) {
+                    for (int x = 0; x < padded; ++x) {
+                        int sx = ((px * TiledTexture::PAGE_SIZE + x - border) % levelWidth + levelWidth) % levelWidth;
+                        int sy = std::min(std::max(py * TiledTexture::PAGE_SIZE + y - border, 0), levelHeight - 1);
+                        for (int c = 0; c < 3; ++c)
+                            sum += std::abs(texels[((size_t)y * padded + x) * 3 + c] - source[((size_t)sy * levelWidth + sx) * 3 + c]);
+                    }
+                }
+                CHECK(sum / (padded * padded * 3) < 4.0);
+            }
+        }
+    }
+
+    std::vector<unsigned char> bytes = readFile(path);
+    bytes.resize(bytes.size() - 1);
+    writeFile(badPath, bytes);
+    TiledTexture truncated;
+    CHECK(!truncated.Open(badPath));
+    bytes = readFile(path);
+    bytes[4] = 9;   // Version
+    writeFile(badPath, bytes);
+    TiledTexture wrongVersion;
+    CHECK(!wrongVersion.Open(badPath));
+
+    std::remove(path.c_str());
+    std::remove(badPath.c_str());
+    return failures;
+}
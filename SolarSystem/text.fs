@@ -1,12 +1,12 @@
 #version 330 core
 in vec2 TexCoords;
+in vec3 TextColor;
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 textColor;
 
 void main()
 {    
     float alpha = texture(text, TexCoords).r;
-    color = vec4(textColor, alpha);
+    color = vec4(TextColor, alpha);
 }
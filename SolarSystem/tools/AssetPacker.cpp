@@ -0,0 +1,51 @@
+// Asset packer: writes files into one memory-mappable .pak archive (see
+// AssetPack.h), stored under the names given on the command line. Run from
+// the SolarSystem directory so the names match the paths the renderer uses.
+//
+// Usage: solarsystem_packer OUT.pak file...
+//        solarsystem_packer --verify PACK.pak
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AssetPack.h"
+
+static int verify(const char* path) {
+    AssetPack pack(path);
+    if (!pack.isValid()) {
+        std::cout << "Failed to open asset pack: " << path << std::endl;
+        return -1;
+    }
+    if (!pack.Verify())
+        return -1;
+    std::printf("%s: %d entries, all hashes match\n", path, pack.getEntryCount());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && !std::strcmp(argv[1], "--verify"))
+        return verify(argv[2]);
+    if (argc < 3) {
+        std::cout << "Usage: solarsystem_packer OUT.pak file...\n"
+                     "       solarsystem_packer --verify PACK.pak" << std::endl;
+        return -1;
+    }
+
+    std::vector<std::string> files(argv + 2, argv + argc);
+    if (!AssetPack::Write(argv[1], files))
+        return -1;
+
+    AssetPack pack(argv[1]);
+    if (!pack.isValid())
+        return -1;
+    size_t total = 0;
+    for (int i = 0; i < pack.getEntryCount(); ++i) {
+        AssetPack::Asset asset = pack.getAsset(i);
+        std::printf("  %-24s %10zu bytes  %016llx\n", pack.getName(i).c_str(), asset.size, (unsigned long long)asset.hash);
+        total += asset.size;
+    }
+    std::printf("%s: %d entries, %.2f MB\n", argv[1], pack.getEntryCount(), total / (1024.0 * 1024.0));
+    return 0;
+}
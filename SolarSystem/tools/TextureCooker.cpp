@@ -0,0 +1,91 @@
+// Texture cooker: converts source images into .stex files (BC1 mip chains,
+// see CookedTexture.h) next to each input, so the renderer uploads them
+// without decoding JPEGs or generating mipmaps at startup.
+//
+// Usage: solarsystem_cooker [--size WxH] [--virtual] image...
+//   --size resamples the following inputs to W x H (the planet texture array
+//   is 2048x1024); without it images keep their own resolution.
+//   --virtual also tiles the following inputs into .vtex page files for
+//   virtual texturing (see TiledTexture.h); sizes must be powers of two.
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Bc1.h"
+#include "CookedTexture.h"
+#include "RgbImage.h"
+#include "TiledTexture.h"
+
+// Root mean square error of level 0 after a round trip through BC1
+static double compressionError(const RgbImage& image, const CookedTexture& cooked) {
+    std::vector<unsigned char> decoded((size_t)image.width * image.height * 3);
+    bc1::Decode(cooked.getLevel(0), image.width, image.height, decoded.data());
+    double sum = 0.0;
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        double difference = (double)decoded[i] - image.pixels[i];
+        sum += difference * difference;
+    }
+    return std::sqrt(sum / decoded.size());
+}
+
+static bool cook(const std::string& path, int width, int height, bool tiled) {
+    RgbImage image;
+    if (!image.Load(path, width, height)) {
+        std::cout << "Failed to load texture: " << path << std::endl;
+        return false;
+    }
+    image.BuildMips();
+
+    CookedTexture cooked;
+    cooked.Encode(image);
+    std::string outPath = CookedTexture::PathFor(path);
+    if (!cooked.Save(outPath))
+        return false;
+
+    std::printf("%s -> %s  %dx%d, %d levels, %.2f MB (RGBA8 in VRAM %.2f MB), rms error %.2f\n",
+        path.c_str(), outPath.c_str(), cooked.width, cooked.height, cooked.getLevelCount(),
+        cooked.getSize() / (1024.0 * 1024.0), image.pixels.size() / 3 * 4 / (1024.0 * 1024.0),
+        compressionError(image, cooked));
+
+    if (tiled) {
+        std::string tiledPath = TiledTexture::PathFor(path);
+        if (!TiledTexture::Write(tiledPath, image))
+            return false;
+        TiledTexture pages;
+        if (!pages.Open(tiledPath))
+            return false;
+        std::printf("%s -> %s  %d levels of %dx%d pages\n", path.c_str(), tiledPath.c_str(), pages.levelCount,
+            TiledTexture::PAGE_SIZE, TiledTexture::PAGE_SIZE);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int width = 0, height = 0;
+    bool tiled = false;
+    int inputs = 0, result = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--size")) {
+            if (i + 1 >= argc || std::sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                std::cout << "Expected --size WxH" << std::endl;
+                return -1;
+            }
+            continue;
+        }
+        if (!std::strcmp(argv[i], "--virtual")) {
+            tiled = true;
+            continue;
+        }
+        ++inputs;
+        if (!cook(argv[i], width, height, tiled))
+            result = -1;
+    }
+    if (inputs == 0) {
+        std::cout << "Usage: solarsystem_cooker [--size WxH] [--virtual] image..." << std::endl;
+        return -1;
+    }
+    return result;
+}